@@ -0,0 +1,136 @@
+-- PageCenterViewNative.lua --
+-- Same API as PageCenterView, driven by the native ccui.PageCenteredView.
+-- Touch, scrolling and layout run in C++, page indices start from 1 as in PageCenterView.
+
+local PageCenterViewNative = class('PageCenterViewNative')
+
+PageCenterViewNative.EventType = {
+	TURNING = 1,
+}
+
+PageCenterViewNative.Direction = {
+	HORIZONTAL = 1,
+	VERTICAL   = 2,
+}
+
+function PageCenterViewNative:ctor(name)
+	self.debugName = name
+
+	self._eventCallback = nil
+
+	self.layout = ccui.PageCenteredView:create()
+	self.layout:setClippingEnabled(true)
+	self.layout:setDirection(PageCenterViewNative.Direction.VERTICAL - 1)
+
+	local onPageEvent = function (sender, eventType)
+		if self._eventCallback then
+			self._eventCallback(self, PageCenterViewNative.EventType.TURNING)
+		end
+	end
+	self.layout:addEventListener(onPageEvent)
+end
+
+function PageCenterViewNative:addEventListener(func)
+	self._eventCallback = func
+end
+
+function PageCenterViewNative:setDirection(direction)
+	self.layout:setDirection(direction - 1)
+end
+
+function PageCenterViewNative:scrollToPage(idx)
+	self.layout:scrollToPage(idx - 1)
+end
+
+function PageCenterViewNative:getCurPageIndex()
+	local idx = self.layout:getCurPageIndex()
+	if idx < 0 then
+		return -1
+	end
+	return idx + 1
+end
+
+function PageCenterViewNative:addPage(page)
+	if not page then
+		return
+	end
+	page:setTouchEnabled(false)
+	self.layout:addPage(page)
+end
+
+function PageCenterViewNative:getPageCount()
+	return #self.layout:getPages()
+end
+
+function PageCenterViewNative:setShowedNum(val)
+	self.layout:setShowedNum(val)
+end
+
+function PageCenterViewNative:setCustomScrollThreshold(threshold)
+	self.layout:setCustomScrollThreshold(threshold)
+	self.layout:setUsingCustomScrollThreshold(true)
+end
+
+function PageCenterViewNative:setMarkWidget(widget)
+	self:addChild(widget)
+	widget:setPositionType(ccui.PositionType.percent)
+	widget:setPositionPercent(cc.p(0.5, 0.5))
+	widget:setTouchEnabled(false)
+end
+
+function PageCenterViewNative:doLayout()
+	self.layout:forceDoLayout()
+end
+
+function PageCenterViewNative:setPosition(pos)
+	self.layout:setPosition(pos)
+end
+
+function PageCenterViewNative:getContentSize()
+	return self.layout:getContentSize()
+end
+
+function PageCenterViewNative:setContentSize(size)
+	self.layout:setContentSize(size)
+end
+
+function PageCenterViewNative:isVisible()
+	local function isVisible(node)
+		if node then
+			if node:isVisible() then
+				return isVisible(node:getParent())
+			else
+				return false
+			end
+		else
+			return true
+		end
+	end
+	return isVisible(self.layout)
+end
+
+function PageCenterViewNative:isEnabled()
+	return self.layout:isEnabled()
+end
+
+function PageCenterViewNative:addChild(child)
+	self.layout:addChild(child)
+end
+
+function PageCenterViewNative:setLocalZOrder(val)
+	self.layout:setLocalZOrder(val)
+end
+
+function PageCenterViewNative:setBackGroundColor(val)
+	self.layout:setBackGroundColor(val)
+end
+
+function PageCenterViewNative:setBackGroundImage(val)
+	self.layout:setBackGroundImage(val)
+end
+
+function PageCenterViewNative:getWidget()
+	return self.layout
+end
+
+return PageCenterViewNative
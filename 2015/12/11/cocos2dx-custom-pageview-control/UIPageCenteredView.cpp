@@ -23,33 +23,155 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "ui/UIPageCenteredView.h"
+#include "base/CCDirector.h"
+#include "base/ccUtils.h"
+#include "renderer/CCTextureCache.h"
+#include "2d/CCTweenFunction.h"
 
 NS_CC_BEGIN
 
 namespace ui {
+
+static const float DEFAULT_AUTO_SCROLL_DURATION = 0.2f;
+static const float DEFAULT_FLING_DECELERATION = 3000.0f;
+static const float MIN_FLING_VELOCITY = 500.0f;
+// a release later than this after the last move doesn't fling
+static const float MAX_FLING_RELEASE_DELAY = 0.1f;
+static const float DEFAULT_TOUCH_MOVE_PREDICTION_HORIZON = 0.02f;
+static const float TOUCH_FILTER_ALPHA = 0.5f;
+static const float TOUCH_FILTER_BETA = 0.2f;
+// the layout origin follows the pages once they are scrolled further than this from it
+static const float MAX_LAYOUT_ORIGIN_DISTANCE = 8192.0f;
+static const float DEFAULT_PAGE_BUILD_BUDGET = 0.002f;
+
+#if CC_PAGECENTEREDVIEW_STATS
+#define PAGECENTEREDVIEW_STAT(__STATEMENT__) do { if (_statsEnabled) { __STATEMENT__; } } while (0)
+#else
+#define PAGECENTEREDVIEW_STAT(__STATEMENT__) do {} while (0)
+#endif
+
+static float easeAutoScroll(PageCenteredView::AutoScrollEasing easing, float percent)
+{
+    switch (easing)
+    {
+        case PageCenteredView::AutoScrollEasing::CUBIC_OUT:
+            return tweenfunc::cubicEaseOut(percent);
+        case PageCenteredView::AutoScrollEasing::QUAD_OUT:
+            return tweenfunc::quadEaseOut(percent);
+        case PageCenteredView::AutoScrollEasing::SPRING:
+        {
+            // under damped spring, damping ratio 0.4, settled at the end of the duration
+            const float omega = 14.0f;
+            const float zeta = 0.4f;
+            const float omegaD = omega * sqrtf(1.0f - zeta * zeta);
+            float t = percent;
+            return 1.0f - expf(-zeta * omega * t) * (cosf(omegaD * t) + zeta * omega / omegaD * sinf(omegaD * t));
+        }
+        case PageCenteredView::AutoScrollEasing::CRITICALLY_DAMPED:
+        {
+            const float omega = 10.0f;
+            float t = percent;
+            return 1.0f - expf(-omega * t) * (1.0f + omega * t);
+        }
+        case PageCenteredView::AutoScrollEasing::LINEAR:
+        default:
+            return percent;
+    }
+}
     
 IMPLEMENT_CLASS_GUI_INFO(PageCenteredView)
 
 PageCenteredView::PageCenteredView():
 _isAutoScrolling(false),
-_autoScrollDistance(0.0f),
-_autoScrollSpeed(0.0f),
+_isUpdateScheduled(false),
 _autoScrollDirection(AutoScrollDirection::LEFT),
+_autoScrollEasing(AutoScrollEasing::LINEAR),
+_autoScrollDuration(DEFAULT_AUTO_SCROLL_DURATION),
+_autoScrollStartOffset(0.0),
+_autoScrollTargetOffset(0.0),
+_autoScrollElapsed(0.0f),
+_autoScrollTotalTime(0.0f),
+_autoScrollCurve(AutoScrollEasing::LINEAR),
 _direction(Direction::VERTICAL),
 _curPageIdx(-1),
+_pageCountCallback(nullptr),
+_configurePageCallback(nullptr),
+_virtualPageCount(0),
+_firstLivePageIdx(0),
+_livePageMargin(1),
+_livePagesDirty(true),
+_circularEnabled(false),
+_innerContainer(nullptr),
+_layoutOriginIdx(0),
+_pageCullingEnabled(true),
+_visibleFirstIdx(0),
+_visibleLastIdx(-1),
+_pagesPositionStale(false),
+_positionedFirstIdx(0),
+_positionedLastIdx(-1),
+_pageEffectEnabled(false),
+_pageEffectScale(1.0f),
+_pageEffectOpacity(255.0f),
+_pageEffectRotation(0.0f),
+_pageEffectRange(1.0f),
+_statsEnabled(false),
+_stats(),
+_dirtyPageIdx(-1),
+_pageSizeDirty(false),
+_contentOffsetDirty(false),
+_pageTexturesCallback(nullptr),
+_pageContentCallback(nullptr),
+_prefetchMargin(1),
+_pageLoadCenterIdx(-1),
+_pageLoadRequestId(0),
+_prefetchAhead(1),
+_evictBehind(-1),
+_prefetchLookaheadTime(0.0f),
+_pageWillAppearCallback(nullptr),
+_pageDidDisappearCallback(nullptr),
+_flingEnabled(false),
+_touchMoveCoalescingEnabled(false),
+_pendingTouchMove(Vec2::ZERO),
+_isDragging(false),
+_touchMovePrediction(TouchMovePrediction::NONE),
+_touchMovePredictionHorizon(DEFAULT_TOUCH_MOVE_PREDICTION_HORIZON),
+_touchMovePredictionLead(0.0f),
+_touchTrackPosition(0.0f),
+_touchFilterPosition(0.0f),
+_touchFilterVelocity(0.0f),
+_flingDeceleration(DEFAULT_FLING_DECELERATION),
+_touchMoveSampleNum(0),
+_touchMoveSampleIdx(0),
+_touchMovePreviousTime(0.0),
 _touchMoveDirection(TouchDirection::LEFT),
 _leftBoundaryChild(nullptr),
 _rightBoundaryChild(nullptr),
-_leftBoundary(0.0f),
-_rightBoundary(0.0f),
 _pageNumShowed(1),
+_slotGeometry(),
+_pageExtentCallback(nullptr),
+_pageExtentsDirty(false),
+_totalPageExtent(0.0),
 _customScrollThreshold(0.0),
 _usingCustomScrollThreshold(false),
 _childFocusCancelOffset(5.0f),
 _pageViewEventListener(nullptr),
 _pageViewEventSelector(nullptr),
-_eventCallback(nullptr)
+_eventCallback(nullptr),
+_pageEventListenerId(0),
+_pageEventDispatchDepth(0),
+_pageEventListenersDirty(false),
+_scrollProgressDirty(false),
+_lastScrollProgress(0.0f),
+_pageMutationCells(nullptr),
+_pageMutationMask(0),
+_pageMutationEnqueuePos(0),
+_pageMutationDequeuePos(0),
+_pageMutationsPerFrame(16),
+_createItemPageCallback(nullptr),
+_pagePlaceholderCallback(nullptr),
+_pageBuildBudget(DEFAULT_PAGE_BUILD_BUDGET)
 {
+    std::fill(_pageEventListenerCounts, _pageEventListenerCounts + PAGE_EVENT_TYPE_NUM, 0);
     this->setTouchEnabled(true);
 }
 
@@ -57,6 +179,7 @@ PageCenteredView::~PageCenteredView()
 {
     _pageViewEventListener = nullptr;
     _pageViewEventSelector = nullptr;
+    delete[] _pageMutationCells.load(std::memory_order_relaxed);
 }
 
 PageCenteredView* PageCenteredView::create()
@@ -82,7 +205,35 @@ void PageCenteredView::onEnter()
 #endif
     
     Layout::onEnter();
-    scheduleUpdate();
+    if (_isAutoScrolling || _pageMutationCells.load(std::memory_order_relaxed) || !_pageBuilders.empty())
+    {
+        scheduleAnimationUpdate();
+    }
+}
+
+void PageCenteredView::cleanup()
+{
+    Layout::cleanup();
+    // cleanup unschedules all the callbacks, update included
+    _isUpdateScheduled = false;
+}
+
+void PageCenteredView::scheduleAnimationUpdate()
+{
+    if (!_isUpdateScheduled)
+    {
+        scheduleUpdate();
+        _isUpdateScheduled = true;
+    }
+}
+
+void PageCenteredView::unscheduleAnimationUpdate()
+{
+    if (_isUpdateScheduled)
+    {
+        unscheduleUpdate();
+        _isUpdateScheduled = false;
+    }
 }
 
 bool PageCenteredView::init()
@@ -95,9 +246,16 @@ bool PageCenteredView::init()
     return false;
 }
 
+void PageCenteredView::initRenderer()
+{
+    Layout::initRenderer();
+    _innerContainer = Layout::create();
+    addProtectedChild(_innerContainer, 1, 1);
+}
+
 void PageCenteredView::addWidgetToPage(Widget *widget, ssize_t pageIdx, bool forceCreate)
 {
-    if (!widget || pageIdx < 0)
+    if (!widget || pageIdx < 0 || isVirtualized())
     {
         return;
     }
@@ -126,40 +284,62 @@ void PageCenteredView::addWidgetToPage(Widget *widget, ssize_t pageIdx, bool for
 Layout* PageCenteredView::createPage()
 {
     Layout* newPage = Layout::create();
+    newPage->setContentSize(getPageSize());
+    return newPage;
+}
+
+const Size& PageCenteredView::getPageSize()const
+{
+    return _slotGeometry.pageSize;
+}
+
+void PageCenteredView::updateSlotGeometry()
+{
 	Size selfSize = getContentSize();
-	Size pageSize = selfSize;
+    Size pageSize = selfSize;
+    float extent = 0.0f;
 	if (_direction == Direction::HORIZONTAL)
 	{
-		pageSize.width = pageSize.width / _pageNumShowed;
+		pageSize.width = selfSize.width / _pageNumShowed;
+        extent = pageSize.width;
 	}
 	else
 	{
-		pageSize.height = pageSize.height / _pageNumShowed;
+		pageSize.height = selfSize.height / _pageNumShowed;
+        extent = pageSize.height;
 	}
-    newPage->setContentSize(pageSize);
-    return newPage;
+    _slotGeometry.pageSize = pageSize;
+    _slotGeometry.extent = extent;
+    _slotGeometry.halfExtent = extent * 0.5f;
+    _slotGeometry.invExtent = extent > 0 ? 1.0f / extent : 0.0f;
+    _slotGeometry.leftBoundary = (_pageNumShowed / 2) * extent;
+    _slotGeometry.rightBoundary = _slotGeometry.leftBoundary + extent;
 }
 
 void PageCenteredView::addPage(Layout* page)
 {
-    if (!page || _pages.contains(page))
+    if (!page || isVirtualized() || !_pageSet.insert(page).second)
     {
         return;
     }
 
     
-    addChild(page);
+    page->setContentSize(getPageSize());
+    page->setVisible(!_pageCullingEnabled);
+    _innerContainer->addChild(page);
     _pages.pushBack(page);
+    splicePageExtents(_pages.size() - 1, 0, 1);
     if (_curPageIdx == -1)
     {
         _curPageIdx = 0;
+        _contentOffsetDirty = true;
     }
-    _doLayoutDirty = true;
+    setPagesPositionDirty(_pages.size() - 1);
 }
 
 void PageCenteredView::insertPage(Layout* page, int idx)
 {
-    if (idx < 0 || !page || _pages.contains(page))
+    if (idx < 0 || !page || isVirtualized() || _pageSet.find(page) != _pageSet.end())
     {
         return;
     }
@@ -172,331 +352,1715 @@ void PageCenteredView::insertPage(Layout* page, int idx)
     }
     else
     {
+        _pageSet.insert(page);
+        page->setContentSize(getPageSize());
+        page->setVisible(!_pageCullingEnabled);
         _pages.insert(idx, page);
-        addChild(page);
+        _innerContainer->addChild(page);
+        splicePageExtents(idx, 0, 1);
         if(_curPageIdx == -1)
         {
             _curPageIdx = 0;
+            _contentOffsetDirty = true;
         }
+        setPagesPositionDirty(idx);
     }
-    
-    _doLayoutDirty = true;
 }
 
 
-void PageCenteredView::removePage(Layout* page)
+void PageCenteredView::insertPages(const Vector<Layout*>& pages, ssize_t idx)
 {
-    if (!page)
+    if (idx < 0 || isVirtualized())
     {
         return;
     }
-    removeChild(page);
-    _pages.eraseObject(page);
-    auto pageCount = _pages.size();
-    if (_curPageIdx >= pageCount)
+
+    ssize_t pageCount = this->getPageCount();
+    if (idx > pageCount)
     {
-        _curPageIdx = pageCount - 1;
+        idx = pageCount;
     }
 
-    _doLayoutDirty = true;
-}
-
-void PageCenteredView::removePageAtIndex(ssize_t index)
-{
-    if (index < 0 || index >= this->getPages().size())
+    // rebuild the page vector once instead of shifting it for every page
+    Vector<Layout*> newPages(pageCount + pages.size());
+    for (ssize_t i = 0; i < idx; i++)
     {
-        return;
+        newPages.pushBack(_pages.at(i));
     }
-    Layout* page = _pages.at(index);
-    removePage(page);
-}
-    
-void PageCenteredView::removeAllPages()
-{
-    for(const auto& node : _pages)
+    const Size& pageSize = getPageSize();
+    for (auto& page : pages)
     {
-        removeChild(node);
+        if (!page || !_pageSet.insert(page).second)
+        {
+            continue;
+        }
+        page->setContentSize(pageSize);
+        page->setVisible(!_pageCullingEnabled);
+        _innerContainer->addChild(page);
+        newPages.pushBack(page);
     }
-    _pages.clear();
-    _curPageIdx = -1;
-}
-
-void PageCenteredView::updateBoundaryPages()
-{
-    if (_pages.size() <= 0)
+    if (newPages.size() == idx)
     {
-        _leftBoundaryChild = nullptr;
-        _rightBoundaryChild = nullptr;
         return;
     }
-    _leftBoundaryChild = _pages.at(0);
-    _rightBoundaryChild = _pages.at(this->getPageCount()-1);
-}
-
-ssize_t PageCenteredView::getPageCount()const
-{
-    return _pages.size();
-}
-
-float PageCenteredView::getPositionXByIndex(ssize_t idx)const
-{
-	Size selfSize = getContentSize();
-	float pageWidth = selfSize.width / _pageNumShowed;
-    return (_leftBoundary + pageWidth * (idx-_curPageIdx));
-}
-    
-float PageCenteredView::getPositionYByIndex(ssize_t idx)const
-{
-	Size selfSize = getContentSize();
-	float pageHeight = selfSize.height / _pageNumShowed;
-    return (_leftBoundary + pageHeight * (idx-_curPageIdx));
-}
-
-void PageCenteredView::onSizeChanged()
-{
-    Layout::onSizeChanged();
-	Size selfSize = getContentSize();
-    if (_direction == Direction::HORIZONTAL)
-    {
-		float pageWidth = selfSize.width / _pageNumShowed;
-		_leftBoundary = (_pageNumShowed / 2) * pageWidth;
-        _rightBoundary = _leftBoundary + pageWidth;
-    }
-    else
+    for (ssize_t i = idx; i < pageCount; i++)
     {
-		float pageHeight = selfSize.height / _pageNumShowed;
-		_leftBoundary = (_pageNumShowed / 2) * pageHeight;
-        _rightBoundary = _leftBoundary + pageHeight;
+        newPages.pushBack(_pages.at(i));
     }
-    
-    _doLayoutDirty = true;
-}
+    _pages = std::move(newPages);
+    splicePageExtents(idx, 0, _pages.size() - pageCount);
 
-void PageCenteredView::updateAllPagesSize()
-{
-    Size selfSize = getContentSize();
-	Size pageSize = selfSize;
-	if (_direction == Direction::HORIZONTAL)
-	{
-		pageSize.width = pageSize.width / _pageNumShowed;
-	}
-	else
-	{
-		pageSize.height = pageSize.height / _pageNumShowed;
-	}
-    for (auto& page : _pages)
+    if (_curPageIdx == -1)
     {
-		page->setContentSize(pageSize);
+        _curPageIdx = 0;
+        _contentOffsetDirty = true;
     }
+    setPagesPositionDirty(idx);
 }
 
-void PageCenteredView::updateAllPagesPosition()
+void PageCenteredView::setPages(const Vector<Layout*>& pages)
 {
-    ssize_t pageCount = this->getPageCount();
-    
-    if (pageCount <= 0)
+    if (isVirtualized())
     {
-        _curPageIdx = -1;
         return;
     }
-    
-    if (_curPageIdx >= pageCount)
+
+    std::unordered_set<Layout*> newPageSet;
+    Vector<Layout*> newPages(pages.size());
+    for (auto& page : pages)
     {
-        _curPageIdx = pageCount-1;
+        if (page && newPageSet.insert(page).second)
+        {
+            newPages.pushBack(page);
+        }
     }
-    // If the layout is dirty, don't trigger auto scroll
-    _isAutoScrolling = false;
 
-	Size selfSize = getContentSize();
-    for (int i=0; i<pageCount; i++)
+    for (auto& page : _pages)
     {
-        Layout* page = _pages.at(i);
-        Vec2 newPosition;
-
-        if (_direction == Direction::HORIZONTAL)
+        if (newPageSet.find(page) == newPageSet.end())
         {
-            float pageWidth = selfSize.width / _pageNumShowed;
-            newPosition =  Vec2(_leftBoundary + (i-_curPageIdx) * pageWidth, 0);
+            forgetPage(page);
+            _innerContainer->removeChild(page);
         }
-        else if(_direction == Direction::VERTICAL)
+    }
+    const Size& pageSize = getPageSize();
+    for (auto& page : newPages)
+    {
+        if (_pageSet.find(page) == _pageSet.end())
         {
-            float pageHeight = selfSize.height / _pageNumShowed;
-            newPosition = Vec2(0, _leftBoundary + (i-_curPageIdx) * pageHeight * -1);
-
+            page->setContentSize(pageSize);
+            _innerContainer->addChild(page);
         }
-        page->setPosition(newPosition);
+        page->setVisible(!_pageCullingEnabled);
     }
-}
+    _visiblePages.clear();
+    _pages = std::move(newPages);
+    _pageSet.swap(newPageSet);
+    _pageExtentsDirty = true;
 
-void PageCenteredView::setCurPageIndex( ssize_t index )
-{
-    if (index < 0 || index >= this->getPageCount())
+    ssize_t pageCount = _pages.size();
+    if (pageCount <= 0)
     {
-        return;
+        _curPageIdx = -1;
     }
-    _curPageIdx = index;
-    _doLayoutDirty = true;
+    else if (_curPageIdx < 0)
+    {
+        _curPageIdx = 0;
+    }
+    else if (_curPageIdx >= pageCount)
+    {
+        _curPageIdx = pageCount - 1;
+    }
+    _contentOffsetDirty = true;
+    setPagesPositionDirty(0);
 }
 
-void PageCenteredView::scrollToPage(ssize_t idx)
+void PageCenteredView::applyItems(const std::vector<std::string>& itemIds, const ccCreateItemPageCallback& createItemPage)
 {
-    if (idx < 0 || idx >= this->getPageCount())
+    if (isVirtualized())
     {
         return;
     }
-    _curPageIdx = idx;
-    Layout* curPage = _pages.at(idx);
 
-	Size selfSize = getContentSize();
-    if (_direction == Direction::HORIZONTAL)
+    // pages of kept keys are reused as is, only the pages of new keys are created
+    std::unordered_set<std::string> newItemIds;
+    std::unordered_set<Layout*> newPageSet;
+    Vector<Layout*> newPages(itemIds.size());
+    const Size& pageSize = getPageSize();
+    for (auto& itemId : itemIds)
     {
-		float pageWidth = selfSize.width / _pageNumShowed;
-        _autoScrollDistance = _leftBoundary - (curPage->getPosition().x);
-        if (_autoScrollDistance > 0)
+        if (!newItemIds.insert(itemId).second)
         {
-            _autoScrollDirection = AutoScrollDirection::RIGHT;
+            continue;
         }
-        else
+        auto it = _itemPages.find(itemId);
+        Layout* page = it != _itemPages.end() ? it->second : (createItemPage ? createItemPage(itemId) : nullptr);
+        if (!page || !newPageSet.insert(page).second)
+        {
+            continue;
+        }
+        if (_pageSet.find(page) == _pageSet.end())
         {
-            _autoScrollDirection = AutoScrollDirection::LEFT;
+            page->setContentSize(pageSize);
+            page->setVisible(!_pageCullingEnabled);
+            _innerContainer->addChild(page);
         }
+        _pageItemIds[page] = itemId;
+        newPages.pushBack(page);
     }
-    else if(_direction == Direction::VERTICAL)
+
+    // the page at the center, or the nearest page kept, the later one first
+    ssize_t oldCount = _pages.size();
+    Layout* centerPage = nullptr;
+    if (_curPageIdx >= 0 && oldCount > 0)
     {
-		float pageHeight = selfSize.height / _pageNumShowed;
-        _autoScrollDistance = _leftBoundary - curPage->getPosition().y;
-        if (_autoScrollDistance > 0)
+        ssize_t curIdx = std::min(wrapPageIndex(_curPageIdx), oldCount - 1);
+        for (ssize_t distance = 0; !centerPage && distance < oldCount; distance++)
         {
-            _autoScrollDirection = AutoScrollDirection::DOWN;
+            if (curIdx + distance < oldCount && newPageSet.find(_pages.at(curIdx + distance)) != newPageSet.end())
+            {
+                centerPage = _pages.at(curIdx + distance);
+            }
+            else if (curIdx - distance >= 0 && newPageSet.find(_pages.at(curIdx - distance)) != newPageSet.end())
+            {
+                centerPage = _pages.at(curIdx - distance);
+            }
         }
-        else
+    }
+
+    // only the pages from the first changed index are laid out again
+    ssize_t newCount = newPages.size();
+    ssize_t dirtyIdx = 0;
+    while (dirtyIdx < newCount && dirtyIdx < oldCount && newPages.at(dirtyIdx) == _pages.at(dirtyIdx))
+    {
+        dirtyIdx++;
+    }
+    if (dirtyIdx == newCount && dirtyIdx == oldCount)
+    {
+        return;
+    }
+
+    for (auto& page : _pages)
+    {
+        if (newPageSet.find(page) == newPageSet.end())
         {
-            _autoScrollDirection = AutoScrollDirection::UP;
+            forgetPage(page);
+            _innerContainer->removeChild(page);
         }
     }
-    _autoScrollSpeed = fabs(_autoScrollDistance)/0.2f;
-    _isAutoScrolling = true;
-}
-    
-void PageCenteredView::setDirection(cocos2d::ui::PageCenteredView::Direction direction)
-{
-    this->_direction = direction;
-}
-    
-PageCenteredView::Direction PageCenteredView::getDirection()const
-{
-    return this->_direction;
-}
+    _pages = std::move(newPages);
+    _pageSet.swap(newPageSet);
+    splicePageExtents(dirtyIdx, oldCount - dirtyIdx, newCount - dirtyIdx);
+    _itemPages.clear();
+    for (auto& it : _pageItemIds)
+    {
+        _itemPages[it.second] = it.first;
+    }
 
-void PageCenteredView::setShowedNum(int val)
-{
-	this->_pageNumShowed = val;
+    if (newCount <= 0)
+    {
+        _curPageIdx = -1;
+    }
+    else if (centerPage)
+    {
+        _curPageIdx = _pages.getIndex(centerPage);
+    }
+    else
+    {
+        _curPageIdx = std::min(std::max<ssize_t>(_curPageIdx, 0), newCount - 1);
+    }
+    _contentOffsetDirty = true;
+    setPagesPositionDirty(_circularEnabled ? 0 : dirtyIdx);
 }
 
-int PageCenteredView::getShowedNum()const
+void PageCenteredView::setPageMutationQueue(const ccCreateItemPageCallback& createItemPage, int capacity, int maxPerFrame)
 {
-	return this->_pageNumShowed;
+    _createItemPageCallback = createItemPage;
+    _pageMutationsPerFrame = std::max(maxPerFrame, 1);
+    // no thread posts while the queue is replaced, see the header
+    delete[] _pageMutationCells.exchange(nullptr, std::memory_order_relaxed);
+    _pageMutationMask = 0;
+    _pageMutationEnqueuePos.store(0, std::memory_order_relaxed);
+    _pageMutationDequeuePos = 0;
+    if (capacity <= 0)
+    {
+        return;
+    }
+
+    size_t cellCount = 1;
+    while (cellCount < static_cast<size_t>(capacity))
+    {
+        cellCount *= 2;
+    }
+    PageMutationCell* cells = new PageMutationCell[cellCount];
+    for (size_t i = 0; i < cellCount; i++)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _pageMutationMask = cellCount - 1;
+    _pageMutationCells.store(cells, std::memory_order_release);
+    // the posting threads can't schedule the update, it stays scheduled while the queue is attached
+    scheduleAnimationUpdate();
 }
 
-void PageCenteredView::update(float dt)
+bool PageCenteredView::postPageMutation(PageMutationType type, const std::string& itemId, ssize_t idx)
 {
-    if (_isAutoScrolling)
+    PageMutationCell* cells = _pageMutationCells.load(std::memory_order_acquire);
+    if (!cells)
     {
-        this->autoScroll(dt);
+        return false;
     }
-}
-    
-void PageCenteredView::autoScroll(float dt)
+
+    // claim the cell at the enqueue position, the sequence tells whether it has been drained
+    size_t pos = _pageMutationEnqueuePos.load(std::memory_order_relaxed);
+    PageMutationCell* cell = nullptr;
+    for (;;)
     {
-        float step = _autoScrollSpeed*dt;
-        int  sign = 1;
-        switch (_autoScrollDirection)
-        {
-            case AutoScrollDirection::LEFT:
-            case AutoScrollDirection::UP:
-            {
-                if (_autoScrollDistance + step >= 0.0f)
-                {
-                    step = -_autoScrollDistance;
-                    _isAutoScrolling = false;
-                    _autoScrollDistance = 0.0f;
-                }
-                else
-                {
-                    _autoScrollDistance += step;
-                }
-                sign = -1;
-                break;
-            }
-                break;
-            case AutoScrollDirection::RIGHT:
-            case AutoScrollDirection::DOWN:
-            {
-                if (_autoScrollDistance - step <= 0.0f)
-                {
-                    step = _autoScrollDistance;
-                    _autoScrollDistance = 0.0f;
-                    _isAutoScrolling = false;
-                }
-                else
-                {
-                    _autoScrollDistance -= step;
-                }
+        cell = &cells[pos & _pageMutationMask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (_pageMutationEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
                 break;
             }
-            default:
-                break;
         }
-        
-        if (_direction == Direction::HORIZONTAL)
+        else if (diff < 0)
         {
-            scrollPages(Vec2(step * sign, 0));
+            return false;
         }
         else
         {
-            scrollPages(Vec2(0, step * sign));
-        }
-
-        if (!_isAutoScrolling)
-        {
-            pageTurningEvent();
+            pos = _pageMutationEnqueuePos.load(std::memory_order_relaxed);
         }
     }
-
-bool PageCenteredView::onTouchBegan(Touch *touch, Event *unusedEvent)
-{
-    bool pass = Layout::onTouchBegan(touch, unusedEvent);
-    return pass;
+    cell->mutation.type = type;
+    cell->mutation.itemId = itemId;
+    cell->mutation.idx = idx;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
 }
 
-void PageCenteredView::onTouchMoved(Touch *touch, Event *unusedEvent)
+void PageCenteredView::drainPageMutations()
 {
-    Layout::onTouchMoved(touch, unusedEvent);
-    if (!_isInterceptTouch)
+    PageMutationCell* cells = nullptr;
+    for (int i = 0; i < _pageMutationsPerFrame && (cells = _pageMutationCells.load(std::memory_order_relaxed)); i++)
     {
-        handleMoveLogic(touch);
+        PageMutationCell& cell = cells[_pageMutationDequeuePos & _pageMutationMask];
+        if (cell.sequence.load(std::memory_order_acquire) != _pageMutationDequeuePos + 1)
+        {
+            break;
+        }
+        // the cell is handed back before the mutation is applied, the callback may detach the queue
+        PageMutation mutation = std::move(cell.mutation);
+        cell.sequence.store(_pageMutationDequeuePos + _pageMutationMask + 1, std::memory_order_release);
+        _pageMutationDequeuePos++;
+        applyPageMutation(mutation.type, mutation.itemId, mutation.idx);
     }
 }
 
-void PageCenteredView::onTouchEnded(Touch *touch, Event *unusedEvent)
+void PageCenteredView::applyPageMutation(PageMutationType type, const std::string& itemId, ssize_t idx)
 {
-    Layout::onTouchEnded(touch, unusedEvent);
-    if (!_isInterceptTouch)
-    {
-        handleReleaseLogic(touch);
-    }
-    _isInterceptTouch = false;
-}
-    
-void PageCenteredView::onTouchCancelled(Touch *touch, Event *unusedEvent)
-{
-    Layout::onTouchCancelled(touch, unusedEvent);
-    if (!_isInterceptTouch)
+    if (isVirtualized())
     {
-        handleReleaseLogic(touch);
+        return;
     }
-    _isInterceptTouch = false;
-}
+
+    auto it = _itemPages.find(itemId);
+    bool inserted = type == PageMutationType::INSERT;
+    ssize_t pageCount = this->getPageCount();
+    Layout* page = nullptr;
+    if (inserted)
+    {
+        if (it != _itemPages.end() || !_createItemPageCallback)
+        {
+            return;
+        }
+        page = _createItemPageCallback(itemId);
+        if (!page || _pageSet.find(page) != _pageSet.end())
+        {
+            return;
+        }
+        if (idx < 0 || idx > pageCount)
+        {
+            idx = pageCount;
+        }
+    }
+    else
+    {
+        if (it == _itemPages.end())
+        {
+            return;
+        }
+        page = it->second;
+        idx = _pages.getIndex(page);
+    }
+
+    // the page showed at the center keeps its place on screen, and the current page stays the same page
+    ssize_t centerIdx = getCenterPageIndex();
+    double centerOffset = getContentOffset() - getContentOffsetByIndex(centerIdx);
+    ssize_t curIdx = _curPageIdx;
+    bool contentOffsetDirty = _contentOffsetDirty;
+    if (inserted)
+    {
+        insertPage(page, static_cast<int>(idx));
+        _pageItemIds[page] = itemId;
+        _itemPages[itemId] = page;
+    }
+    else
+    {
+        removePage(page);
+    }
+    if (pageCount <= 0 || this->getPageCount() <= 0)
+    {
+        // the first page is centered, and nothing is left to keep when the last one goes
+        return;
+    }
+    if (_circularEnabled)
+    {
+        _layoutOriginIdx = getMutatedPageSlot(_layoutOriginIdx, idx, pageCount, inserted);
+    }
+    _curPageIdx = getMutatedPageSlot(curIdx, idx, pageCount, inserted);
+    _contentOffsetDirty = contentOffsetDirty;
+    centerIdx = getMutatedPageSlot(centerIdx, idx, pageCount, inserted);
+    moveContentOffset(getContentOffsetByIndex(centerIdx) + centerOffset - getContentOffset());
+
+    // a running scroll goes on to its page, wherever the mutation moved it
+    if (_isAutoScrolling)
+    {
+        double targetOffset = getContentOffsetByIndex(_curPageIdx);
+        if (targetOffset != _autoScrollTargetOffset)
+        {
+            startAutoScroll(targetOffset, std::max(_autoScrollTotalTime - _autoScrollElapsed, 0.0f), _autoScrollCurve);
+        }
+    }
+}
+
+ssize_t PageCenteredView::getMutatedPageSlot(ssize_t slot, ssize_t mutatedIdx, ssize_t pageCount, bool inserted)const
+{
+    // the slot of the same page once a page is inserted at or removed from mutatedIdx,
+    // in circular mode the turn of the slot is kept
+    ssize_t idx = slot;
+    ssize_t turns = 0;
+    if (_circularEnabled)
+    {
+        idx = slot % pageCount;
+        if (idx < 0)
+        {
+            idx += pageCount;
+        }
+        turns = (slot - idx) / pageCount;
+    }
+    if (inserted ? idx >= mutatedIdx : idx > mutatedIdx)
+    {
+        idx += inserted ? 1 : -1;
+    }
+    ssize_t newCount = pageCount + (inserted ? 1 : -1);
+    if (!_circularEnabled && !inserted && idx == mutatedIdx && idx == newCount)
+    {
+        // the removed last page hands its slot over to the page before it
+        idx--;
+    }
+    return idx + turns * newCount;
+}
+
+void PageCenteredView::removePage(Layout* page)
+{
+    if (!page || isVirtualized())
+    {
+        return;
+    }
+    if (_pageSet.erase(page) == 0)
+    {
+        return;
+    }
+    ssize_t idx = _pages.getIndex(page);
+    forgetPage(page);
+    _innerContainer->removeChild(page);
+    _pages.erase(idx);
+    splicePageExtents(idx, 1, 0);
+    auto pageCount = _pages.size();
+    if (_curPageIdx >= pageCount)
+    {
+        _curPageIdx = pageCount - 1;
+        _contentOffsetDirty = true;
+    }
+
+    setPagesPositionDirty(idx);
+}
+
+void PageCenteredView::removePageAtIndex(ssize_t index)
+{
+    if (index < 0 || index >= this->getPages().size())
+    {
+        return;
+    }
+    Layout* page = _pages.at(index);
+    removePage(page);
+}
+    
+void PageCenteredView::removeAllPages()
+{
+    for(const auto& node : _pages)
+    {
+        node->setVisible(true);
+        if (_pageEffectEnabled)
+        {
+            resetPageEffect(node);
+        }
+        _innerContainer->removeChild(node);
+    }
+    _pages.clear();
+    _pageSet.clear();
+    _visiblePages.clear();
+    _pageLoadInfos.clear();
+    _pageItemIds.clear();
+    _itemPages.clear();
+    _pageBuilders.clear();
+    _curPageIdx = -1;
+    _firstLivePageIdx = 0;
+    _layoutOriginIdx = 0;
+    _pagesPositionStale = false;
+    _pageExtents.clear();
+    _pageExtentTree.clear();
+    _totalPageExtent = 0.0;
+}
+
+void PageCenteredView::setDataSource(const ccPageCountCallback& pageCount, const ccConfigurePageCallback& configurePage, int margin)
+{
+    removeAllPages();
+    _pageCountCallback = pageCount;
+    _configurePageCallback = configurePage;
+    _livePageMargin = std::max(margin, 0);
+    reloadData();
+}
+
+bool PageCenteredView::isVirtualized()const
+{
+    return _pageCountCallback && _configurePageCallback;
+}
+
+void PageCenteredView::reloadData()
+{
+    if (!isVirtualized())
+    {
+        _virtualPageCount = 0;
+        return;
+    }
+    _virtualPageCount = std::max<ssize_t>(_pageCountCallback(), 0);
+    if (_virtualPageCount <= 0)
+    {
+        _curPageIdx = -1;
+    }
+    else if (_curPageIdx < 0)
+    {
+        _curPageIdx = 0;
+    }
+    else if (_curPageIdx >= _virtualPageCount)
+    {
+        _curPageIdx = _virtualPageCount - 1;
+    }
+    _livePagesDirty = true;
+    _pageExtentsDirty = true;
+    _doLayoutDirty = true;
+}
+
+bool PageCenteredView::updateLivePages(ssize_t centerIdx)
+{
+    ssize_t pageCount = this->getPageCount();
+    ssize_t liveCount = std::min<ssize_t>(pageCount, _pageNumShowed + 2 * _livePageMargin);
+    bool rebindAll = _livePagesDirty || _pages.size() != liveCount;
+    while (_pages.size() > liveCount)
+    {
+        Layout* page = _pages.back();
+        forgetPage(page);
+        _innerContainer->removeChild(page);
+        _pages.popBack();
+    }
+    while (_pages.size() < liveCount)
+    {
+        Layout* newPage = createPage();
+        newPage->setVisible(!_pageCullingEnabled);
+        _innerContainer->addChild(newPage);
+        _pages.pushBack(newPage);
+    }
+    _livePagesDirty = false;
+    if (liveCount <= 0)
+    {
+        _firstLivePageIdx = 0;
+        return rebindAll;
+    }
+
+    ssize_t firstIdx = getFirstLivePageIndex(centerIdx);
+    if (rebindAll || std::abs(firstIdx - _firstLivePageIdx) >= liveCount)
+    {
+        _firstLivePageIdx = firstIdx;
+        for (ssize_t i = 0; i < liveCount; i++)
+        {
+            configureLivePage(_pages.at(i), _firstLivePageIdx + i);
+        }
+        return true;
+    }
+    // pages still in the window keep their binding, only the pages leaving it are bound again
+    if (firstIdx == _firstLivePageIdx)
+    {
+        return false;
+    }
+    while (_firstLivePageIdx < firstIdx)
+    {
+        Layout* page = _pages.at(0);
+        _pages.erase(0);
+        _pages.pushBack(page);
+        configureLivePage(page, _firstLivePageIdx + liveCount);
+        _firstLivePageIdx++;
+    }
+    while (_firstLivePageIdx > firstIdx)
+    {
+        _firstLivePageIdx--;
+        Layout* page = _pages.at(liveCount - 1);
+        _pages.popBack();
+        _pages.insert(0, page);
+        configureLivePage(page, _firstLivePageIdx);
+    }
+    return true;
+}
+
+void PageCenteredView::recycleLivePages()
+{
+    ssize_t liveCount = _pages.size();
+    ssize_t pageCount = this->getPageCount();
+    if (liveCount <= 0 || (!_circularEnabled && liveCount >= pageCount))
+    {
+        return;
+    }
+
+    // keep the live window centered on the page showed at _slotGeometry.leftBoundary
+    ssize_t firstIdx = getFirstLivePageIndex(getCenterPageIndex());
+    if (firstIdx == _firstLivePageIdx)
+    {
+        return;
+    }
+
+    bool virtualized = isVirtualized();
+    if (std::abs(firstIdx - _firstLivePageIdx) >= liveCount)
+    {
+        _firstLivePageIdx = firstIdx;
+        for (ssize_t i = 0; i < liveCount; i++)
+        {
+            Layout* page = _pages.at(i);
+            ssize_t slot = getLivePageSlot(i);
+            page->setPosition(getPageLayoutPosition(slot));
+            if (virtualized)
+            {
+                configureLivePage(page, slot);
+            }
+        }
+        PAGECENTEREDVIEW_STAT(_stats.pagesRepositioned += liveCount; _stats.setPositionCalls += liveCount);
+    }
+    // the page leaving one end of the window is moved to the other end
+    while (_firstLivePageIdx < firstIdx)
+    {
+        if (virtualized)
+        {
+            Layout* page = _pages.at(0);
+            _pages.erase(0);
+            _pages.pushBack(page);
+            page->setPosition(getPageLayoutPosition(_firstLivePageIdx + liveCount));
+            configureLivePage(page, _firstLivePageIdx + liveCount);
+        }
+        else
+        {
+            _pages.at(wrapPageIndex(_firstLivePageIdx))->setPosition(getPageLayoutPosition(_firstLivePageIdx + liveCount));
+        }
+        _firstLivePageIdx++;
+        PAGECENTEREDVIEW_STAT(_stats.pagesRepositioned++; _stats.setPositionCalls++);
+    }
+    while (_firstLivePageIdx > firstIdx)
+    {
+        _firstLivePageIdx--;
+        if (virtualized)
+        {
+            Layout* page = _pages.at(liveCount - 1);
+            _pages.popBack();
+            _pages.insert(0, page);
+            page->setPosition(getPageLayoutPosition(_firstLivePageIdx));
+            configureLivePage(page, _firstLivePageIdx);
+        }
+        else
+        {
+            _pages.at(wrapPageIndex(_firstLivePageIdx))->setPosition(getPageLayoutPosition(_firstLivePageIdx));
+        }
+        PAGECENTEREDVIEW_STAT(_stats.pagesRepositioned++; _stats.setPositionCalls++);
+    }
+    updateBoundaryPages();
+    // recycled pages are bound to new indices, rebuild the visible window
+    updateVisiblePages(true);
+    updatePageLoading(true);
+}
+
+ssize_t PageCenteredView::getFirstLivePageIndex(ssize_t centerIdx)const
+{
+    ssize_t liveCount = _pages.size();
+    if (!_circularEnabled)
+    {
+        return isVirtualized() ? std::min(std::max<ssize_t>(centerIdx - _pageNumShowed / 2 - _livePageMargin, 0), this->getPageCount() - liveCount) : 0;
+    }
+    return centerIdx - (isVirtualized() ? _pageNumShowed / 2 + _livePageMargin : (liveCount - 1) / 2);
+}
+
+ssize_t PageCenteredView::getLivePageSlot(ssize_t liveIdx)const
+{
+    if (_circularEnabled && !isVirtualized())
+    {
+        // all the pages form a ring starting at _firstLivePageIdx
+        return _firstLivePageIdx + wrapPageIndex(liveIdx - _firstLivePageIdx);
+    }
+    return _firstLivePageIdx + liveIdx;
+}
+
+ssize_t PageCenteredView::wrapPageIndex(ssize_t idx)const
+{
+    ssize_t pageCount = this->getPageCount();
+    if (!_circularEnabled || pageCount <= 0)
+    {
+        return idx;
+    }
+    idx %= pageCount;
+    return idx < 0 ? idx + pageCount : idx;
+}
+
+ssize_t PageCenteredView::getNearestPageSlot(ssize_t idx)const
+{
+    ssize_t pageCount = this->getPageCount();
+    ssize_t centerIdx = getCenterPageIndex();
+    if (std::abs(idx - centerIdx) * 2 <= pageCount)
+    {
+        return idx;
+    }
+    ssize_t distance = wrapPageIndex(idx - centerIdx);
+    if (distance * 2 > pageCount)
+    {
+        distance -= pageCount;
+    }
+    return centerIdx + distance;
+}
+
+void PageCenteredView::rebaseCircularSlots()
+{
+    ssize_t shift = _curPageIdx - wrapPageIndex(_curPageIdx);
+    if (shift == 0)
+    {
+        return;
+    }
+    // bring the current page back to its own slot, so indices stay small however far the pages turn.
+    // The layout origin is shifted along, nothing moves on screen
+    _curPageIdx -= shift;
+    _layoutOriginIdx -= shift;
+    _firstLivePageIdx -= shift;
+    _visibleFirstIdx -= shift;
+    _visibleLastIdx -= shift;
+    _positionedFirstIdx -= shift;
+    _positionedLastIdx -= shift;
+    _pageLoadCenterIdx -= shift;
+    for (auto& it : _pageLoadInfos)
+    {
+        it.second.idx -= shift;
+    }
+}
+
+void PageCenteredView::rebaseLayoutOrigin(ssize_t originIdx)
+{
+    if (originIdx == _layoutOriginIdx)
+    {
+        return;
+    }
+    // lay the pages out from the new origin and move the container by as much, so nothing moves on screen
+    double shift = getPageDistanceFromOrigin(originIdx);
+    _layoutOriginIdx = originIdx;
+    moveContentOffset(_direction == Direction::HORIZONTAL ? shift : -shift);
+    if (_pageCullingEnabled)
+    {
+        // only the showed pages are laid out again, culled pages are when they're showed
+        _pagesPositionStale = true;
+        _positionedFirstIdx = 0;
+        _positionedLastIdx = -1;
+        updateVisiblePages(true);
+    }
+    else
+    {
+        updatePagesPosition(0);
+    }
+    updatePageEffects();
+}
+
+void PageCenteredView::moveContentOffset(double offset)
+{
+    if (offset == 0.0)
+    {
+        return;
+    }
+    // a running auto scroll is moved along, so it goes on undisturbed
+    _innerContainer->setPosition(_innerContainer->getPosition() + (_direction == Direction::HORIZONTAL ? Vec2(offset, 0) : Vec2(0, offset)));
+    _autoScrollStartOffset += offset;
+    _autoScrollTargetOffset += offset;
+    PAGECENTEREDVIEW_STAT(_stats.setPositionCalls++);
+    setScrollProgressDirty();
+}
+
+void PageCenteredView::configureLivePage(Layout* page, ssize_t idx)
+{
+    auto it = _pageLoadInfos.find(page);
+    if (it != _pageLoadInfos.end())
+    {
+        ssize_t oldIdx = it->second.idx;
+        _pageLoadInfos.erase(it);
+        notifyPageDidDisappear(page, oldIdx);
+    }
+    if (!_pageExtents.empty())
+    {
+        page->setContentSize(getPageSizeByIndex(idx));
+    }
+    // the page shows the placeholder of its new index until it's loaded again
+    _configurePageCallback(page, wrapPageIndex(idx));
+}
+
+void PageCenteredView::forgetPage(Layout* page)
+{
+    // culling owned the visibility of the page and the effect its transform, it leaves PageView without them
+    page->setVisible(true);
+    if (_pageEffectEnabled)
+    {
+        resetPageEffect(page);
+    }
+    _visiblePages.erase(std::remove(_visiblePages.begin(), _visiblePages.end(), page), _visiblePages.end());
+    _pageLoadInfos.erase(page);
+    _pageBuilders.erase(page);
+    auto it = _pageItemIds.find(page);
+    if (it != _pageItemIds.end())
+    {
+        _itemPages.erase(it->second);
+        _pageItemIds.erase(it);
+    }
+}
+
+ssize_t PageCenteredView::getCenterPageIndex()const
+{
+    return getPageIndexByContentOffset(getContentOffset());
+}
+
+float PageCenteredView::getContentOffset()const
+{
+    Vec2 innerPosition = _innerContainer->getPosition();
+    return _direction == Direction::HORIZONTAL ? innerPosition.x : innerPosition.y;
+}
+
+double PageCenteredView::getContentOffsetByIndex(ssize_t idx)const
+{
+    double distance = getPageDistanceFromOrigin(idx);
+    return _direction == Direction::HORIZONTAL ? _slotGeometry.leftBoundary - distance : _slotGeometry.leftBoundary + distance;
+}
+
+ssize_t PageCenteredView::getPageIndexByContentOffset(float offset)const
+{
+    return static_cast<ssize_t>(round(getSlotByContentOffset(offset)));
+}
+
+double PageCenteredView::getSlotByContentOffset(float offset)const
+{
+    const Size& pageSize = _slotGeometry.pageSize;
+    if (pageSize.width <= 0 || pageSize.height <= 0)
+    {
+        return _curPageIdx;
+    }
+    // the offset is relative to the layout origin, the slot is found from the exact origin index
+    double distance = _direction == Direction::HORIZONTAL ? _slotGeometry.leftBoundary - offset : offset - _slotGeometry.leftBoundary;
+    if (_pageExtents.empty())
+    {
+        return _layoutOriginIdx + distance * _slotGeometry.invExtent;
+    }
+    return getSlotByDistance(getPageStart(_layoutOriginIdx) + distance);
+}
+
+double PageCenteredView::getSlotByDistance(double distance)const
+{
+    ssize_t pageCount = _pageExtents.size();
+    double base = 0.0;
+    if (_circularEnabled && _totalPageExtent > 0)
+    {
+        double turns = floor(distance / _totalPageExtent);
+        base = turns * pageCount;
+        distance -= turns * _totalPageExtent;
+    }
+    else if (distance < 0)
+    {
+        return distance * _slotGeometry.invExtent;
+    }
+    else if (distance >= _totalPageExtent)
+    {
+        return pageCount + (distance - _totalPageExtent) * _slotGeometry.invExtent;
+    }
+
+    // descend the Fenwick tree to the last page starting at or before the distance
+    ssize_t idx = 0;
+    ssize_t step = 1;
+    while (step * 2 <= pageCount)
+    {
+        step *= 2;
+    }
+    for (; step > 0; step /= 2)
+    {
+        if (idx + step <= pageCount && _pageExtentTree[idx + step] <= distance)
+        {
+            idx += step;
+            distance -= _pageExtentTree[idx];
+        }
+    }
+    if (idx >= pageCount)
+    {
+        return base + pageCount;
+    }
+    float extent = _pageExtents[idx];
+    return base + idx + (extent > 0 ? std::min(distance / extent, 1.0) : 0.0);
+}
+
+void PageCenteredView::updateVisiblePages(bool forceUpdate)
+{
+    if (!_pageCullingEnabled)
+    {
+        return;
+    }
+
+    ssize_t firstIdx = 0;
+    ssize_t lastIdx = -1;
+    if (_pages.size() > 0)
+    {
+        if (_pageExtents.empty())
+        {
+            ssize_t centerIdx = getCenterPageIndex();
+            firstIdx = centerIdx - _pageNumShowed / 2 - 1;
+            lastIdx = centerIdx + _pageNumShowed / 2 + 1;
+        }
+        else
+        {
+            // the pages overlapping the view, the leading edge of the current slot is at leftBoundary
+            float offset = getContentOffset();
+            float viewExtent = _direction == Direction::HORIZONTAL ? getContentSize().width : getContentSize().height;
+            float before = _slotGeometry.leftBoundary;
+            float after = viewExtent - _slotGeometry.leftBoundary;
+            double distance = _slotGeometry.leftBoundary - offset;
+            if (_direction == Direction::VERTICAL)
+            {
+                before = viewExtent - _slotGeometry.rightBoundary;
+                after = _slotGeometry.rightBoundary;
+                distance = offset - _slotGeometry.leftBoundary;
+            }
+            distance += getPageStart(_layoutOriginIdx);
+            firstIdx = static_cast<ssize_t>(floor(getSlotByDistance(distance - before))) - 1;
+            lastIdx = static_cast<ssize_t>(floor(getSlotByDistance(distance + after))) + 1;
+        }
+        firstIdx = std::max(_firstLivePageIdx, firstIdx);
+        lastIdx = std::min(_firstLivePageIdx + _pages.size() - 1, lastIdx);
+    }
+    if (!forceUpdate && firstIdx == _visibleFirstIdx && lastIdx == _visibleLastIdx)
+    {
+        return;
+    }
+
+    // pages outside _visiblePages are always culled, so only the window is visited
+    std::swap(_visiblePages, _lastVisiblePages);
+    _visiblePages.clear();
+    for (ssize_t idx = firstIdx; idx <= lastIdx; idx++)
+    {
+        Layout* page = getLivePage(idx);
+        if (page)
+        {
+            if (_pagesPositionStale && (idx < _positionedFirstIdx || idx > _positionedLastIdx))
+            {
+                page->setPosition(getPageLayoutPosition(idx));
+                PAGECENTEREDVIEW_STAT(_stats.pagesRepositioned++; _stats.setPositionCalls++);
+            }
+            page->setVisible(true);
+            _visiblePages.push_back(page);
+        }
+    }
+    if (_pagesPositionStale && firstIdx <= lastIdx)
+    {
+        // the laid out range stays contiguous, a window apart from it replaces it
+        if (firstIdx > _positionedLastIdx + 1 || lastIdx < _positionedFirstIdx - 1)
+        {
+            _positionedFirstIdx = firstIdx;
+            _positionedLastIdx = lastIdx;
+        }
+        else
+        {
+            _positionedFirstIdx = std::min(_positionedFirstIdx, firstIdx);
+            _positionedLastIdx = std::max(_positionedLastIdx, lastIdx);
+        }
+    }
+    for (auto& page : _lastVisiblePages)
+    {
+        if (std::find(_visiblePages.begin(), _visiblePages.end(), page) == _visiblePages.end())
+        {
+            page->setVisible(false);
+        }
+    }
+    _lastVisiblePages.clear();
+    _visibleFirstIdx = firstIdx;
+    _visibleLastIdx = lastIdx;
+}
+
+void PageCenteredView::setPageCullingEnabled(bool enabled)
+{
+    if (_pageCullingEnabled == enabled)
+    {
+        return;
+    }
+    _pageCullingEnabled = enabled;
+    for (auto& page : _pages)
+    {
+        page->setVisible(!enabled);
+    }
+    if (_pagesPositionStale)
+    {
+        // every page is showed from now on
+        updatePagesPosition(0);
+    }
+    _visiblePages.clear();
+    updateVisiblePages(true);
+    updatePageEffects();
+}
+
+bool PageCenteredView::isPageCullingEnabled()const
+{
+    return _pageCullingEnabled;
+}
+
+void PageCenteredView::setCircularEnabled(bool enabled)
+{
+    if (_circularEnabled == enabled)
+    {
+        return;
+    }
+    _curPageIdx = wrapPageIndex(_curPageIdx);
+    _circularEnabled = enabled;
+    if (!isVirtualized())
+    {
+        _firstLivePageIdx = 0;
+    }
+    // the pages out of range are bound to other indices
+    _livePagesDirty = true;
+    _contentOffsetDirty = true;
+    setPagesPositionDirty(0);
+}
+
+bool PageCenteredView::isCircularEnabled()const
+{
+    return _circularEnabled;
+}
+
+void PageCenteredView::setPageEffectEnabled(bool enabled)
+{
+    if (_pageEffectEnabled == enabled)
+    {
+        return;
+    }
+    _pageEffectEnabled = enabled;
+    if (enabled)
+    {
+        updatePageEffects();
+    }
+    else
+    {
+        resetPageEffects();
+    }
+}
+
+bool PageCenteredView::isPageEffectEnabled()const
+{
+    return _pageEffectEnabled;
+}
+
+void PageCenteredView::setPageEffect(float edgeScale, float edgeOpacity, float edgeRotation, float range)
+{
+    _pageEffectScale = edgeScale;
+    _pageEffectOpacity = std::min(std::max(edgeOpacity, 0.0f), 255.0f);
+    _pageEffectRotation = edgeRotation;
+    _pageEffectRange = std::max(range, 0.01f);
+    updatePageEffects();
+}
+
+void PageCenteredView::updatePageEffects()
+{
+    if (!_pageEffectEnabled || _pages.size() <= 0)
+    {
+        return;
+    }
+
+    // only the window of visible pages is affected, all the live pages without culling
+    ssize_t firstIdx = _firstLivePageIdx;
+    ssize_t lastIdx = _firstLivePageIdx + _pages.size() - 1;
+    if (_pageCullingEnabled)
+    {
+        firstIdx = _visibleFirstIdx;
+        lastIdx = _visibleLastIdx;
+    }
+    double centerSlot = getSlotByContentOffset(getContentOffset());
+    _effectPages.clear();
+    _effectDistances.clear();
+    for (ssize_t idx = firstIdx; idx <= lastIdx; idx++)
+    {
+        Layout* page = getLivePage(idx);
+        if (page)
+        {
+            _effectPages.push_back(page);
+            _effectDistances.push_back(idx - centerSlot);
+        }
+    }
+
+    size_t count = _effectPages.size();
+    _effectScales.resize(count);
+    _effectOpacities.resize(count);
+    _effectRotations.resize(count);
+    const float* distances = _effectDistances.data();
+    float* scales = _effectScales.data();
+    float* opacities = _effectOpacities.data();
+    float* rotations = _effectRotations.data();
+    float invRange = 1.0f / _pageEffectRange;
+    float scaleDelta = _pageEffectScale - 1.0f;
+    float opacityDelta = _pageEffectOpacity - 255.0f;
+    // branchless over plain float arrays, so the compiler can vectorize it
+    for (size_t i = 0; i < count; i++)
+    {
+        float t = std::min(fabsf(distances[i]) * invRange, 1.0f);
+        scales[i] = 1.0f + scaleDelta * t;
+        opacities[i] = 255.0f + opacityDelta * t;
+        rotations[i] = _pageEffectRotation * copysignf(t, distances[i]);
+    }
+
+    // pages are scaled and tilted around their center
+    const Size& pageSize = _slotGeometry.pageSize;
+    Vec2 halfPage(pageSize.width * 0.5f, pageSize.height * 0.5f);
+    bool horizontal = _direction == Direction::HORIZONTAL;
+    for (size_t i = 0; i < count; i++)
+    {
+        Layout* page = _effectPages[i];
+        ssize_t slot = firstIdx + static_cast<ssize_t>(i);
+        if (!_pageExtents.empty())
+        {
+            (horizontal ? halfPage.x : halfPage.y) = getPageExtent(slot) * 0.5f;
+        }
+        page->setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+        page->setPosition(getPageLayoutPosition(slot) + halfPage);
+        page->setScale(scales[i]);
+        page->setOpacity(static_cast<GLubyte>(opacities[i]));
+        page->setRotation3D(horizontal ? Vec3(0, rotations[i], 0) : Vec3(rotations[i], 0, 0));
+    }
+    PAGECENTEREDVIEW_STAT(_stats.setPositionCalls += count);
+}
+
+void PageCenteredView::resetPageEffects()
+{
+    for (auto& page : _pages)
+    {
+        resetPageEffect(page);
+    }
+    updatePagesPosition(0);
+}
+
+void PageCenteredView::resetPageEffect(Layout* page)
+{
+    page->setAnchorPoint(Vec2::ZERO);
+    page->setScale(1.0f);
+    page->setOpacity(255);
+    page->setRotation3D(Vec3(0, 0, 0));
+}
+
+void PageCenteredView::setStatsEnabled(bool enabled)
+{
+    _statsEnabled = enabled;
+}
+
+bool PageCenteredView::isStatsEnabled()const
+{
+    return _statsEnabled;
+}
+
+const PageCenteredView::Stats& PageCenteredView::getStats()const
+{
+    return _stats;
+}
+
+void PageCenteredView::resetStats()
+{
+    _stats = Stats();
+}
+
+void PageCenteredView::updateBoundaryPages()
+{
+    if (_pages.size() <= 0)
+    {
+        _leftBoundaryChild = nullptr;
+        _rightBoundaryChild = nullptr;
+        return;
+    }
+    _leftBoundaryChild = _pages.at(0);
+    _rightBoundaryChild = _pages.at(_pages.size()-1);
+}
+
+ssize_t PageCenteredView::getPageCount()const
+{
+    if (isVirtualized())
+    {
+        return _virtualPageCount;
+    }
+    return _pages.size();
+}
+
+Layout* PageCenteredView::getLivePage(ssize_t idx)const
+{
+    ssize_t liveIdx = idx - _firstLivePageIdx;
+    if (liveIdx < 0 || liveIdx >= _pages.size())
+    {
+        return nullptr;
+    }
+    if (_circularEnabled && !isVirtualized())
+    {
+        return _pages.at(wrapPageIndex(idx));
+    }
+    return _pages.at(liveIdx);
+}
+
+Vec2 PageCenteredView::getPagePosition(ssize_t idx)const
+{
+    return _innerContainer->getPosition() + getPageLayoutPosition(idx);
+}
+
+Vec2 PageCenteredView::getPageLayoutPosition(ssize_t idx)const
+{
+    // pages are laid out by index from the layout origin in the inner container,
+    // the current page is brought to _slotGeometry.leftBoundary by the container offset
+    float distance = getPageDistanceFromOrigin(idx);
+    if (_direction == Direction::HORIZONTAL)
+    {
+        return Vec2(distance, 0);
+    }
+    if (_pageExtents.empty())
+    {
+        return Vec2(0, -distance);
+    }
+    // vertical pages hang from the top of their slot
+    return Vec2(0, _slotGeometry.extent - distance - getPageExtent(idx));
+}
+
+double PageCenteredView::getPageDistanceFromOrigin(ssize_t idx)const
+{
+    if (_pageExtents.empty())
+    {
+        return static_cast<double>(idx - _layoutOriginIdx) * _slotGeometry.extent;
+    }
+    return getPageStart(idx) - getPageStart(_layoutOriginIdx);
+}
+
+Size PageCenteredView::getPageSizeByIndex(ssize_t idx)const
+{
+    Size pageSize = _slotGeometry.pageSize;
+    if (_direction == Direction::HORIZONTAL)
+    {
+        pageSize.width = getPageExtent(idx);
+    }
+    else
+    {
+        pageSize.height = getPageExtent(idx);
+    }
+    return pageSize;
+}
+
+float PageCenteredView::getPageExtent(ssize_t idx)const
+{
+    ssize_t pageCount = _pageExtents.size();
+    idx = wrapPageIndex(idx);
+    if (idx < 0 || idx >= pageCount)
+    {
+        return _slotGeometry.extent;
+    }
+    return _pageExtents[idx];
+}
+
+double PageCenteredView::getPageStart(ssize_t idx)const
+{
+    ssize_t pageCount = _pageExtents.size();
+    if (pageCount <= 0)
+    {
+        return static_cast<double>(idx) * _slotGeometry.extent;
+    }
+    if (_circularEnabled)
+    {
+        ssize_t wrappedIdx = wrapPageIndex(idx);
+        return static_cast<double>((idx - wrappedIdx) / pageCount) * _totalPageExtent + getPageExtentPrefix(wrappedIdx);
+    }
+    // pages before the first or after the last one are laid out with the uniform extent
+    if (idx < 0)
+    {
+        return static_cast<double>(idx) * _slotGeometry.extent;
+    }
+    if (idx >= pageCount)
+    {
+        return _totalPageExtent + static_cast<double>(idx - pageCount) * _slotGeometry.extent;
+    }
+    return getPageExtentPrefix(idx);
+}
+
+double PageCenteredView::getPageExtentPrefix(ssize_t count)const
+{
+    // sum of the extents of the first count pages
+    double sum = 0.0;
+    for (ssize_t i = count; i > 0; i -= i & -i)
+    {
+        sum += _pageExtentTree[i];
+    }
+    return sum;
+}
+
+void PageCenteredView::rebuildPageExtents()
+{
+    ssize_t pageCount = this->getPageCount();
+    _pageExtents.resize(pageCount);
+    for (ssize_t i = 0; i < pageCount; i++)
+    {
+        _pageExtents[i] = std::max(_pageExtentCallback(i), 0.0f);
+    }
+    updatePageExtentTree(0);
+    _pageExtentsDirty = false;
+}
+
+void PageCenteredView::splicePageExtents(ssize_t idx, ssize_t removedCount, ssize_t insertedCount)
+{
+    if (!_pageExtentCallback || _pageExtentsDirty)
+    {
+        return;
+    }
+    ssize_t pageCount = _pageExtents.size();
+    if (idx < 0 || idx + removedCount > pageCount || pageCount - removedCount + insertedCount != this->getPageCount())
+    {
+        // out of step with the pages, rebuilt on the next layout
+        _pageExtentsDirty = true;
+        return;
+    }
+
+    // only the pages from idx are queried, and only the tree nodes after it are summed again
+    bool keepCurrent = !_circularEnabled && _curPageIdx >= 0;
+    double curDistance = keepCurrent ? getPageDistanceFromOrigin(_curPageIdx) : 0.0;
+    _pageExtents.erase(_pageExtents.begin() + idx, _pageExtents.begin() + idx + removedCount);
+    _pageExtents.insert(_pageExtents.begin() + idx, insertedCount, 0.0f);
+    for (ssize_t i = idx; i < idx + insertedCount; i++)
+    {
+        _pageExtents[i] = std::max(_pageExtentCallback(i), 0.0f);
+        _pages.at(i)->setContentSize(getPageSizeByIndex(i));
+    }
+    updatePageExtentTree(idx);
+
+    // the current index stays at the center, as with uniform pages
+    if (keepCurrent)
+    {
+        double shift = getPageDistanceFromOrigin(_curPageIdx) - curDistance;
+        moveContentOffset(_direction == Direction::HORIZONTAL ? -shift : shift);
+    }
+    // pages before the layout origin are laid out from it, they move as well
+    if (idx < _layoutOriginIdx)
+    {
+        setPagesPositionDirty(0);
+    }
+}
+
+void PageCenteredView::updatePageExtentTree(ssize_t fromIdx)
+{
+    ssize_t pageCount = _pageExtents.size();
+    _pageExtentTree.resize(pageCount + 1);
+    // a node sums its own extent and its children, which all come before it
+    for (ssize_t i = fromIdx + 1; i <= pageCount; i++)
+    {
+        double sum = _pageExtents[i - 1];
+        ssize_t lowBit = i & -i;
+        for (ssize_t child = 1; child < lowBit; child *= 2)
+        {
+            sum += _pageExtentTree[i - child];
+        }
+        _pageExtentTree[i] = sum;
+    }
+    _totalPageExtent = getPageExtentPrefix(pageCount);
+}
+
+void PageCenteredView::setPageExtentCallback(const ccPageExtentCallback& pageExtent)
+{
+    _pageExtentCallback = pageExtent;
+    _pageExtents.clear();
+    _pageExtentTree.clear();
+    _totalPageExtent = 0.0;
+    _pageSizeDirty = true;
+    _contentOffsetDirty = true;
+    setPagesPositionDirty(0);
+}
+
+void PageCenteredView::updatePageExtent(ssize_t idx)
+{
+    ssize_t pageCount = _pageExtents.size();
+    if (!_pageExtentCallback || _pageExtentsDirty || idx < 0 || idx >= pageCount)
+    {
+        return;
+    }
+    float extent = std::max(_pageExtentCallback(idx), 0.0f);
+    double delta = extent - _pageExtents[idx];
+    if (delta == 0.0)
+    {
+        return;
+    }
+    bool keepCurrent = !_circularEnabled && _curPageIdx >= 0;
+    double curDistance = keepCurrent ? getPageDistanceFromOrigin(_curPageIdx) : 0.0;
+    _pageExtents[idx] = extent;
+    for (ssize_t i = idx + 1; i <= pageCount; i += i & -i)
+    {
+        _pageExtentTree[i] += delta;
+    }
+    _totalPageExtent += delta;
+
+    // only the page itself is resized, the pages after it move, the other extents stay valid
+    Layout* page = getLivePage(idx);
+    if (page)
+    {
+        page->setContentSize(getPageSizeByIndex(idx));
+    }
+    ssize_t dirtyIdx = _circularEnabled || idx < _layoutOriginIdx ? 0 : idx;
+    if (_dirtyPageIdx < 0 || dirtyIdx < _dirtyPageIdx)
+    {
+        _dirtyPageIdx = dirtyIdx;
+    }
+    if (_circularEnabled)
+    {
+        _contentOffsetDirty = true;
+    }
+    else if (keepCurrent)
+    {
+        // the current page keeps its place without interrupting the scrolling
+        double shift = getPageDistanceFromOrigin(_curPageIdx) - curDistance;
+        moveContentOffset(_direction == Direction::HORIZONTAL ? -shift : shift);
+    }
+    _doLayoutDirty = true;
+}
+
+float PageCenteredView::getPositionXByIndex(ssize_t idx)const
+{
+    return (_slotGeometry.leftBoundary + getPageStart(idx) - getPageStart(_curPageIdx));
+}
+    
+float PageCenteredView::getPositionYByIndex(ssize_t idx)const
+{
+    return (_slotGeometry.leftBoundary + getPageStart(idx) - getPageStart(_curPageIdx));
+}
+
+void PageCenteredView::onSizeChanged()
+{
+    Layout::onSizeChanged();
+    _innerContainer->setContentSize(getContentSize());
+    updateSlotGeometry();
+    
+    _pageSizeDirty = true;
+    _pageExtentsDirty = true;
+    setPagesPositionDirty(0);
+}
+
+void PageCenteredView::updateAllPagesSize()
+{
+    if (!_pageExtents.empty())
+    {
+        for (ssize_t i = 0; i < _pages.size(); i++)
+        {
+            _pages.at(i)->setContentSize(getPageSizeByIndex(getLivePageSlot(i)));
+        }
+        return;
+    }
+    const Size& pageSize = getPageSize();
+    for (auto& page : _pages)
+    {
+		page->setContentSize(pageSize);
+    }
+}
+
+void PageCenteredView::updateAllPagesPosition()
+{
+    updatePagesPosition(0);
+    updateContentOffset();
+}
+
+void PageCenteredView::updatePagesPosition(ssize_t fromIdx)
+{
+    ssize_t liveCount = _pages.size();
+    // in circular mode slots don't follow the page indices
+    ssize_t firstIdx = _circularEnabled ? 0 : std::max<ssize_t>(fromIdx - _firstLivePageIdx, 0);
+    for (ssize_t i = firstIdx; i < liveCount; i++)
+    {
+        _pages.at(i)->setPosition(getPageLayoutPosition(getLivePageSlot(i)));
+    }
+    if (_pagesPositionStale)
+    {
+        if (firstIdx == 0)
+        {
+            _pagesPositionStale = false;
+        }
+        else if (firstIdx < liveCount && _firstLivePageIdx + firstIdx <= _positionedLastIdx + 1)
+        {
+            _positionedFirstIdx = std::min(_positionedFirstIdx, _firstLivePageIdx + firstIdx);
+            _positionedLastIdx = _firstLivePageIdx + liveCount - 1;
+        }
+    }
+    PAGECENTEREDVIEW_STAT(if (liveCount > firstIdx) { _stats.pagesRepositioned += liveCount - firstIdx; _stats.setPositionCalls += liveCount - firstIdx; });
+}
+
+void PageCenteredView::updateContentOffset()
+{
+    ssize_t pageCount = this->getPageCount();
+    
+    if (pageCount <= 0)
+    {
+        _curPageIdx = -1;
+        return;
+    }
+    
+    if (_curPageIdx >= pageCount)
+    {
+        _curPageIdx = pageCount-1;
+    }
+    // If the layout is dirty, don't trigger auto scroll
+    _isAutoScrolling = false;
+
+    float curPageOffset = getContentOffsetByIndex(_curPageIdx);
+    if (_direction == Direction::HORIZONTAL)
+    {
+        _innerContainer->setPosition(Vec2(curPageOffset, 0));
+    }
+    else
+    {
+        _innerContainer->setPosition(Vec2(0, curPageOffset));
+    }
+    PAGECENTEREDVIEW_STAT(_stats.setPositionCalls++);
+    setScrollProgressDirty();
+}
+
+void PageCenteredView::setPagesPositionDirty(ssize_t fromIdx)
+{
+    if (_dirtyPageIdx < 0 || fromIdx < _dirtyPageIdx)
+    {
+        _dirtyPageIdx = fromIdx;
+    }
+    _doLayoutDirty = true;
+}
+
+void PageCenteredView::setCurPageIndex( ssize_t index )
+{
+    if (index < 0 || index >= this->getPageCount())
+    {
+        return;
+    }
+    _curPageIdx = index;
+    _contentOffsetDirty = true;
+    _doLayoutDirty = true;
+}
+
+void PageCenteredView::scrollToPage(ssize_t idx)
+{
+    if (_circularEnabled && this->getPageCount() > 0)
+    {
+        idx = getNearestPageSlot(idx);
+    }
+    else if (idx < 0 || idx >= this->getPageCount())
+    {
+        return;
+    }
+    _curPageIdx = idx;
+    startAutoScroll(getContentOffsetByIndex(idx), _autoScrollDuration, _autoScrollEasing);
+}
+
+void PageCenteredView::startAutoScroll(double targetOffset, float duration, AutoScrollEasing easing)
+{
+    _autoScrollStartOffset = getContentOffset();
+    _autoScrollTargetOffset = targetOffset;
+    _autoScrollElapsed = 0.0f;
+    _autoScrollTotalTime = duration;
+    _autoScrollCurve = easing;
+
+    double distance = _autoScrollTargetOffset - _autoScrollStartOffset;
+    if (_direction == Direction::HORIZONTAL)
+    {
+        _autoScrollDirection = distance > 0 ? AutoScrollDirection::RIGHT : AutoScrollDirection::LEFT;
+    }
+    else
+    {
+        _autoScrollDirection = distance > 0 ? AutoScrollDirection::DOWN : AutoScrollDirection::UP;
+    }
+    _isAutoScrolling = true;
+    scheduleAnimationUpdate();
+}
+
+void PageCenteredView::setAutoScrollEasing(AutoScrollEasing easing)
+{
+    _autoScrollEasing = easing;
+}
+
+PageCenteredView::AutoScrollEasing PageCenteredView::getAutoScrollEasing()const
+{
+    return _autoScrollEasing;
+}
+
+void PageCenteredView::setAutoScrollDuration(float duration)
+{
+    CCASSERT(duration >= 0, "Invalid duration!");
+    _autoScrollDuration = duration;
+}
+
+float PageCenteredView::getAutoScrollDuration()const
+{
+    return _autoScrollDuration;
+}
+    
+void PageCenteredView::setDirection(cocos2d::ui::PageCenteredView::Direction direction)
+{
+    if (_direction == direction)
+    {
+        return;
+    }
+    this->_direction = direction;
+    updateSlotGeometry();
+    _pageSizeDirty = true;
+    _pageExtentsDirty = true;
+    _contentOffsetDirty = true;
+    setPagesPositionDirty(0);
+}
+    
+PageCenteredView::Direction PageCenteredView::getDirection()const
+{
+    return this->_direction;
+}
+
+void PageCenteredView::setShowedNum(int val)
+{
+    if (val <= 0 || _pageNumShowed == val)
+    {
+        return;
+    }
+	this->_pageNumShowed = val;
+    updateSlotGeometry();
+    _pageSizeDirty = true;
+    _pageExtentsDirty = true;
+    _contentOffsetDirty = true;
+    setPagesPositionDirty(0);
+}
+
+int PageCenteredView::getShowedNum()const
+{
+	return this->_pageNumShowed;
+}
+
+void PageCenteredView::update(float dt)
+{
+    drainPageMutations();
+    flushTouchMove();
+    if (_isAutoScrolling)
+    {
+        this->autoScroll(dt);
+    }
+    buildDeferredPages();
+    dispatchScrollProgress();
+    // idle views don't stay in the scheduler, unless they drain a mutation queue or build pages
+    if (!_isAutoScrolling && !(_touchMoveCoalescingEnabled && _isDragging) && !_pageMutationCells.load(std::memory_order_relaxed) && _pageBuilders.empty())
+    {
+        unscheduleAnimationUpdate();
+    }
+}
+    
+void PageCenteredView::autoScroll(float dt)
+{
+#if CC_PAGECENTEREDVIEW_STATS
+    double startTime = _statsEnabled ? utils::gettime() : 0.0;
+#endif
+    // the offset is evaluated from the elapsed time, so uneven frames never accumulate error
+    _autoScrollElapsed = std::min(_autoScrollElapsed + dt, _autoScrollTotalTime);
+    double offset = _autoScrollTargetOffset;
+    if (_autoScrollElapsed < _autoScrollTotalTime)
+    {
+        float percent = easeAutoScroll(_autoScrollCurve, _autoScrollElapsed / _autoScrollTotalTime);
+        offset = _autoScrollStartOffset + (_autoScrollTargetOffset - _autoScrollStartOffset) * percent;
+    }
+    else
+    {
+        _isAutoScrolling = false;
+    }
+
+    float step = static_cast<float>(offset - getContentOffset());
+    if (_direction == Direction::HORIZONTAL)
+    {
+        movePages(Vec2(step, 0));
+    }
+    else
+    {
+        movePages(Vec2(0, step));
+    }
+
+#if CC_PAGECENTEREDVIEW_STATS
+    PAGECENTEREDVIEW_STAT(_stats.autoScrollTime += utils::gettime() - startTime);
+#endif
+
+    if (!_isAutoScrolling)
+    {
+        if (_circularEnabled)
+        {
+            rebaseCircularSlots();
+        }
+        pageTurningEvent();
+    }
+}
+
+bool PageCenteredView::onTouchBegan(Touch *touch, Event *unusedEvent)
+{
+    bool pass = Layout::onTouchBegan(touch, unusedEvent);
+    if (pass)
+    {
+        // catching the pages stops the auto scroll
+        _isAutoScrolling = false;
+        _isDragging = true;
+        _pendingTouchMove = Vec2::ZERO;
+        resetTouchMoveSamples();
+    }
+    return pass;
+}
+
+void PageCenteredView::onTouchMoved(Touch *touch, Event *unusedEvent)
+{
+    Layout::onTouchMoved(touch, unusedEvent);
+    if (!_isInterceptTouch)
+    {
+        handleMoveLogic(touch);
+    }
+}
+
+void PageCenteredView::onTouchEnded(Touch *touch, Event *unusedEvent)
+{
+    Layout::onTouchEnded(touch, unusedEvent);
+    if (!_isInterceptTouch)
+    {
+        handleReleaseLogic(touch);
+    }
+    _isInterceptTouch = false;
+}
+    
+void PageCenteredView::onTouchCancelled(Touch *touch, Event *unusedEvent)
+{
+    Layout::onTouchCancelled(touch, unusedEvent);
+    if (!_isInterceptTouch)
+    {
+        handleReleaseLogic(touch);
+    }
+    _isInterceptTouch = false;
+}
 
 void PageCenteredView::doLayout()
 {
@@ -504,22 +2068,397 @@ void PageCenteredView::doLayout()
     {
         return;
     }
-    
-    updateAllPagesPosition();
-    updateAllPagesSize();
+
+    if (_dirtyPageIdx < 0 && !_pageSizeDirty && !_contentOffsetDirty)
+    {
+        // dirtied by Layout itself, relayout everything
+        _pageSizeDirty = true;
+        _dirtyPageIdx = 0;
+    }
+    PAGECENTEREDVIEW_STAT(_stats.layoutPasses++);
+    // pages are laid out by index, so pages added or removed leave the container, and any scroll running, as they are
+    if (_pageSizeDirty)
+    {
+        _contentOffsetDirty = true;
+    }
+    if (_circularEnabled && !_isAutoScrolling && wrapPageIndex(_curPageIdx) != _curPageIdx)
+    {
+        _curPageIdx = wrapPageIndex(_curPageIdx);
+        _contentOffsetDirty = true;
+    }
+    // the live pages are laid out around the page at the center, or the current page when the offset is reset
+    ssize_t centerIdx = _contentOffsetDirty ? _curPageIdx : getCenterPageIndex();
+    if (isVirtualized())
+    {
+        // rebound pages may have moved in the live window, so every live page is repositioned
+        if (updateLivePages(centerIdx))
+        {
+            _dirtyPageIdx = 0;
+        }
+    }
+    else if (_circularEnabled)
+    {
+        _firstLivePageIdx = getFirstLivePageIndex(centerIdx);
+        _dirtyPageIdx = 0;
+    }
+    if (_pageExtentCallback && (_pageExtentsDirty || static_cast<ssize_t>(_pageExtents.size()) != this->getPageCount()))
+    {
+        rebuildPageExtents();
+        _pageSizeDirty = true;
+        _contentOffsetDirty = true;
+        _dirtyPageIdx = 0;
+    }
+    // the layout origin follows a far jump of the current page, before the pages are laid out
+    if (_contentOffsetDirty && _curPageIdx >= 0 && fabs(getPageDistanceFromOrigin(_curPageIdx)) > MAX_LAYOUT_ORIGIN_DISTANCE)
+    {
+        _layoutOriginIdx = _curPageIdx;
+        _dirtyPageIdx = 0;
+    }
+
+    if (_pageSizeDirty)
+    {
+        updateAllPagesSize();
+    }
+    if (_dirtyPageIdx >= 0)
+    {
+        updatePagesPosition(_dirtyPageIdx);
+    }
+    if (_contentOffsetDirty)
+    {
+        updateContentOffset();
+    }
     updateBoundaryPages();
+    updateVisiblePages(true);
+    updatePageEffects();
+    updatePageLoading(true);
 
-    
+    _pageSizeDirty = false;
+    _contentOffsetDirty = false;
+    _dirtyPageIdx = -1;
     _doLayoutDirty = false;
 }
 
 void PageCenteredView::movePages(Vec2 offset)
 {
-    for (auto& page : this->getPages())
+    // pages are laid out once in the inner container, only the container is translated
+    _innerContainer->setPosition(_innerContainer->getPosition() + offset);
+    PAGECENTEREDVIEW_STAT(_stats.setPositionCalls++);
+    if (fabsf(getContentOffset() - _slotGeometry.leftBoundary) > MAX_LAYOUT_ORIGIN_DISTANCE)
+    {
+        rebaseLayoutOrigin(getCenterPageIndex());
+    }
+    setScrollProgressDirty();
+    if (isVirtualized() || _circularEnabled)
+    {
+        recycleLivePages();
+    }
+    updateVisiblePages(false);
+    updatePageEffects();
+    updatePageLoading(false);
+}
+
+void PageCenteredView::setAsyncPageLoader(const ccPageTexturesCallback& pageTextures, const ccPageContentCallback& pageContent, int prefetchMargin)
+{
+    _pageTexturesCallback = pageTextures;
+    _pageContentCallback = pageContent;
+    _prefetchMargin = std::max(prefetchMargin, 0);
+    _pageLoadInfos.clear();
+    updatePageLoading(true);
+}
+
+Layout* PageCenteredView::addDeferredPage(const ccBuildPageCallback& build, ssize_t idx)
+{
+    if (!build || isVirtualized())
+    {
+        return nullptr;
+    }
+    Layout* page = createPage();
+    if (_pagePlaceholderCallback)
+    {
+        _pagePlaceholderCallback(page);
+    }
+    if (idx < 0 || idx >= this->getPageCount())
+    {
+        addPage(page);
+    }
+    else
+    {
+        insertPage(page, static_cast<int>(idx));
+    }
+    _pageBuilders[page] = build;
+    scheduleAnimationUpdate();
+    return page;
+}
+
+void PageCenteredView::setDeferredPagePlaceholder(const ccBuildPageCallback& placeholder)
+{
+    _pagePlaceholderCallback = placeholder;
+}
+
+void PageCenteredView::setPageBuildBudget(float budget)
+{
+    _pageBuildBudget = std::max(budget, 0.0f);
+}
+
+float PageCenteredView::getPageBuildBudget()const
+{
+    return _pageBuildBudget;
+}
+
+void PageCenteredView::buildDeferredPages()
+{
+    if (_pageBuilders.empty())
+    {
+        return;
+    }
+
+    // build from the current page outwards until the budget of the frame is spent
+    double startTime = utils::gettime();
+    ssize_t pageCount = _pages.size();
+    ssize_t curIdx = std::min(std::max<ssize_t>(wrapPageIndex(_curPageIdx), 0), pageCount - 1);
+    for (ssize_t distance = 0; distance < pageCount && !_pageBuilders.empty(); distance++)
+    {
+        for (int side = 0; side < 2; side++)
+        {
+            ssize_t idx = wrapPageIndex(side == 0 ? curIdx + distance : curIdx - distance);
+            if ((side == 1 && distance == 0) || idx < 0 || idx >= _pages.size())
+            {
+                continue;
+            }
+            Layout* page = _pages.at(idx);
+            auto it = _pageBuilders.find(page);
+            if (it == _pageBuilders.end())
+            {
+                continue;
+            }
+            ccBuildPageCallback build = it->second;
+            _pageBuilders.erase(it);
+            page->removeAllChildren();
+            build(page);
+            if (utils::gettime() - startTime >= _pageBuildBudget)
+            {
+                return;
+            }
+        }
+    }
+}
+
+void PageCenteredView::setPrefetchPolicy(int aheadPages, int evictBehindPages, float lookaheadTime)
+{
+    _prefetchAhead = std::max(aheadPages, 0);
+    _evictBehind = evictBehindPages;
+    _prefetchLookaheadTime = std::max(lookaheadTime, 0.0f);
+    updatePageLoading(true);
+}
+
+void PageCenteredView::setPageAppearanceCallbacks(const ccPageAppearanceCallback& willAppear, const ccPageAppearanceCallback& didDisappear)
+{
+    _pageWillAppearCallback = willAppear;
+    _pageDidDisappearCallback = didDisappear;
+}
+
+void PageCenteredView::notifyPageWillAppear(Layout* page, ssize_t idx)
+{
+    idx = wrapPageIndex(idx);
+    if (_pageWillAppearCallback)
+    {
+        _pageWillAppearCallback(page, idx);
+    }
+    if (hasPageEventListener(PageEventType::PAGE_WILL_APPEAR))
+    {
+        dispatchPageEvent({PageEventType::PAGE_WILL_APPEAR, idx, page, 0.0f});
+    }
+}
+
+void PageCenteredView::notifyPageDidDisappear(Layout* page, ssize_t idx)
+{
+    idx = wrapPageIndex(idx);
+    if (_pageDidDisappearCallback)
+    {
+        _pageDidDisappearCallback(page, idx);
+    }
+    if (hasPageEventListener(PageEventType::PAGE_DID_DISAPPEAR))
+    {
+        dispatchPageEvent({PageEventType::PAGE_DID_DISAPPEAR, idx, page, 0.0f});
+    }
+}
+
+int PageCenteredView::getScrollIndexDirection()const
+{
+    // auto scroll LEFT and DOWN, like touch LEFT and UP, bring the following pages in
+    if (_isAutoScrolling)
+    {
+        return (_autoScrollDirection == AutoScrollDirection::LEFT || _autoScrollDirection == AutoScrollDirection::DOWN) ? 1 : -1;
+    }
+    return (_touchMoveDirection == TouchDirection::LEFT || _touchMoveDirection == TouchDirection::UP) ? 1 : -1;
+}
+
+float PageCenteredView::getScrollSpeed()const
+{
+    if (_isAutoScrolling)
+    {
+        return _autoScrollTotalTime > 0 ? fabs(_autoScrollTargetOffset - _autoScrollStartOffset) / _autoScrollTotalTime : 0.0f;
+    }
+    return fabs(calculateTouchMoveVelocity());
+}
+
+void PageCenteredView::updatePageLoading(bool forceUpdate)
+{
+    bool appearanceListened = _pageWillAppearCallback || _pageDidDisappearCallback
+        || hasPageEventListener(PageEventType::PAGE_WILL_APPEAR) || hasPageEventListener(PageEventType::PAGE_DID_DISAPPEAR);
+    if ((!_pageContentCallback && !appearanceListened) || _pages.size() <= 0)
+    {
+        return;
+    }
+    ssize_t centerIdx = getCenterPageIndex();
+    if (!forceUpdate && centerIdx == _pageLoadCenterIdx)
+    {
+        return;
+    }
+    _pageLoadCenterIdx = centerIdx;
+
+    // the window reaches further ahead of the motion, the faster the pages move
+    ssize_t aheadPages = std::max(_prefetchMargin, _prefetchAhead);
+    float pageExtent = _slotGeometry.extent;
+    if (_prefetchLookaheadTime > 0 && pageExtent > 0)
+    {
+        aheadPages += static_cast<ssize_t>(getScrollSpeed() * _prefetchLookaheadTime / pageExtent);
+    }
+    ssize_t behindPages = _prefetchMargin;
+    int direction = getScrollIndexDirection();
+    ssize_t halfShowed = _pageNumShowed / 2;
+    ssize_t firstIdx = centerIdx - halfShowed - (direction > 0 ? behindPages : aheadPages);
+    ssize_t lastIdx = centerIdx + halfShowed + (direction > 0 ? aheadPages : behindPages);
+
+    if (_evictBehind >= 0)
+    {
+        evictPages(std::min(firstIdx, centerIdx - halfShowed - _evictBehind), std::max(lastIdx, centerIdx + halfShowed + _evictBehind));
+    }
+
+    // request the window from the center page outwards, ahead of the motion first
+    for (ssize_t distance = 0; distance <= halfShowed + std::max(aheadPages, behindPages); distance++)
+    {
+        ssize_t idx = centerIdx + distance * direction;
+        if (idx >= firstIdx && idx <= lastIdx)
+        {
+            requestPageLoad(idx);
+        }
+        idx = centerIdx - distance * direction;
+        if (distance > 0 && idx >= firstIdx && idx <= lastIdx)
+        {
+            requestPageLoad(idx);
+        }
+    }
+}
+
+void PageCenteredView::evictPages(ssize_t keepFirstIdx, ssize_t keepLastIdx)
+{
+    _evictedPages.clear();
+    for (auto it = _pageLoadInfos.begin(); it != _pageLoadInfos.end();)
+    {
+        Layout* page = it->first;
+        PageLoadInfo& info = it->second;
+        if (getLivePage(info.idx) != page)
+        {
+            // indices of a non virtualized PageView shift on insertion and removal
+            info.idx = getLivePageSlot(_pages.getIndex(page));
+        }
+        if (info.idx < keepFirstIdx || info.idx > keepLastIdx)
+        {
+            _evictedPages.push_back(std::make_pair(page, info));
+            it = _pageLoadInfos.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // the page is loaded again if it comes back into the prefetch window
+    bool virtualized = isVirtualized();
+    for (auto& evicted : _evictedPages)
+    {
+        Layout* page = evicted.first;
+        ssize_t idx = evicted.second.idx;
+        notifyPageDidDisappear(page, idx);
+        // loaded content is dropped for the placeholder, so only the prefetch window stays resident
+        if (virtualized && evicted.second.loaded && getLivePage(idx) == page && _pageLoadInfos.find(page) == _pageLoadInfos.end())
+        {
+            _configurePageCallback(page, wrapPageIndex(idx));
+        }
+    }
+    _evictedPages.clear();
+}
+
+void PageCenteredView::requestPageLoad(ssize_t idx)
+{
+    Layout* page = getLivePage(idx);
+    if (!page || _pageLoadInfos.find(page) != _pageLoadInfos.end())
+    {
+        return;
+    }
+
+    unsigned int requestId = ++_pageLoadRequestId;
+    PageLoadInfo& info = _pageLoadInfos[page];
+    info.idx = idx;
+    info.requestId = requestId;
+    info.pendingTextures = 0;
+    info.loaded = false;
+
+    if (_pageWillAppearCallback || hasPageEventListener(PageEventType::PAGE_WILL_APPEAR))
+    {
+        notifyPageWillAppear(page, idx);
+        // the callbacks may have changed the pages
+        auto it = _pageLoadInfos.find(page);
+        if (it == _pageLoadInfos.end() || it->second.requestId != requestId)
+        {
+            return;
+        }
+    }
+
+    std::vector<std::string> textures;
+    if (_pageTexturesCallback && _pageContentCallback)
+    {
+        textures = _pageTexturesCallback(wrapPageIndex(idx));
+    }
+    if (textures.empty())
+    {
+        finishPageLoad(page, requestId);
+        return;
+    }
+
+    _pageLoadInfos[page].pendingTextures = textures.size();
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (const auto& file : textures)
+    {
+        // decoded on the texture cache loading thread, the callback runs on the main thread
+        this->retain();
+        textureCache->addImageAsync(file, [this, page, requestId](Texture2D*) {
+            auto it = _pageLoadInfos.find(page);
+            if (it != _pageLoadInfos.end() && it->second.requestId == requestId && --it->second.pendingTextures <= 0)
+            {
+                finishPageLoad(page, requestId);
+            }
+            this->release();
+        });
+    }
+}
+
+void PageCenteredView::finishPageLoad(Layout* page, unsigned int requestId)
+{
+    auto it = _pageLoadInfos.find(page);
+    if (it == _pageLoadInfos.end() || it->second.requestId != requestId)
     {
-        Vec2 oldPosition = page->getPosition();
-        page->setPosition(oldPosition + offset);
+        return;
+    }
+    it->second.loaded = true;
+    if (!_pageContentCallback)
+    {
+        return;
     }
+    // indices of a non virtualized PageView may have shifted while loading
+    ssize_t idx = isVirtualized() ? wrapPageIndex(it->second.idx) : _pages.getIndex(page);
+    _pageContentCallback(page, idx);
 }
 
 bool PageCenteredView::scrollPages(Vec2 touchOffset)
@@ -533,36 +2472,64 @@ bool PageCenteredView::scrollPages(Vec2 touchOffset)
     {
         return false;
     }
+
+    if (_circularEnabled)
+    {
+        // no first nor last page to stop at
+        movePages(touchOffset);
+        return true;
+    }
     
     Vec2 realOffset = touchOffset;
+
+    // edges of the first and last page in PageView space, they don't need to be alive in virtualized mode
+    float pageExtent = _slotGeometry.extent;
+    Vec2 firstPagePos = getPagePosition(0);
+    Vec2 lastPagePos = getPagePosition(this->getPageCount() - 1);
+    float firstPageEdge = 0.0f;
+    float lastPageEdge = 0.0f;
+    if (_direction == Direction::HORIZONTAL)
+    {
+        firstPageEdge = firstPagePos.x;
+        lastPageEdge = lastPagePos.x + pageExtent;
+    }
+    else
+    {
+        // variable pages hang from the top of their slot
+        firstPageEdge = firstPagePos.y + getPageExtent(0);
+        lastPageEdge = lastPagePos.y + getPageExtent(this->getPageCount() - 1) - pageExtent;
+    }
     
     switch (_touchMoveDirection)
     {
         case TouchDirection::LEFT: // left
-            if (_rightBoundaryChild->getRightBoundary() + touchOffset.x <= _rightBoundary)
+            if (lastPageEdge + touchOffset.x <= _slotGeometry.rightBoundary)
             {
-                realOffset.x = _rightBoundary - _rightBoundaryChild->getRightBoundary();
+                realOffset.x = _slotGeometry.rightBoundary - lastPageEdge;
                 realOffset.y = 0;
+                PAGECENTEREDVIEW_STAT(_stats.boundaryClamps++);
                 movePages(realOffset);
                 return false;
             }
             break;
             
         case TouchDirection::RIGHT: // right
-            if (_leftBoundaryChild->getLeftBoundary() + touchOffset.x >= _leftBoundary)
+            if (firstPageEdge + touchOffset.x >= _slotGeometry.leftBoundary)
             {
-                realOffset.x = _leftBoundary - _leftBoundaryChild->getLeftBoundary();
+                realOffset.x = _slotGeometry.leftBoundary - firstPageEdge;
                 realOffset.y = 0;
+                PAGECENTEREDVIEW_STAT(_stats.boundaryClamps++);
                 movePages(realOffset);
                 return false;
             }
             break;
         case TouchDirection::UP:
         {
-            if (_rightBoundaryChild->getBottomBoundary() + touchOffset.y >= _leftBoundary)
+            if (lastPageEdge + touchOffset.y >= _slotGeometry.leftBoundary)
             {
-                realOffset.y = _leftBoundary - _rightBoundaryChild->getBottomBoundary();
+                realOffset.y = _slotGeometry.leftBoundary - lastPageEdge;
                 realOffset.x = 0;
+                PAGECENTEREDVIEW_STAT(_stats.boundaryClamps++);
                 movePages(realOffset);
                 return false;
             }
@@ -570,10 +2537,11 @@ bool PageCenteredView::scrollPages(Vec2 touchOffset)
         }break;
         case TouchDirection::DOWN:
         {
-            if (_leftBoundaryChild->getTopBoundary() + touchOffset.y <= _rightBoundary)
+            if (firstPageEdge + touchOffset.y <= _slotGeometry.rightBoundary)
             {
-                realOffset.y = _rightBoundary - _leftBoundaryChild->getTopBoundary();
+                realOffset.y = _slotGeometry.rightBoundary - firstPageEdge;
                 realOffset.x = 0;
+                PAGECENTEREDVIEW_STAT(_stats.boundaryClamps++);
                 movePages(realOffset);
                 return false;
             }
@@ -589,6 +2557,9 @@ bool PageCenteredView::scrollPages(Vec2 touchOffset)
 
 void PageCenteredView::handleMoveLogic(Touch *touch)
 {
+#if CC_PAGECENTEREDVIEW_STATS
+    double startTime = _statsEnabled ? utils::gettime() : 0.0;
+#endif
     Vec2 touchPoint = touch->getLocation();
     
     Vec2 offset;
@@ -619,7 +2590,228 @@ void PageCenteredView::handleMoveLogic(Touch *touch)
         }
     }
    
-    scrollPages(offset);
+    float delta = _direction == Direction::HORIZONTAL ? offset.x : offset.y;
+    gatherTouchMove(delta);
+    if (_touchMovePrediction != TouchMovePrediction::NONE)
+    {
+        // correct the previous prediction with the real move
+        float lead = predictTouchMoveLead(delta);
+        if (_direction == Direction::HORIZONTAL)
+        {
+            offset.x += lead - _touchMovePredictionLead;
+        }
+        else
+        {
+            offset.y += lead - _touchMovePredictionLead;
+        }
+        _touchMovePredictionLead = lead;
+    }
+
+    _pendingTouchMove += offset;
+    if (_touchMoveCoalescingEnabled)
+    {
+        // scrolled once per frame in update
+        scheduleAnimationUpdate();
+    }
+    else
+    {
+        flushTouchMove();
+    }
+#if CC_PAGECENTEREDVIEW_STATS
+    PAGECENTEREDVIEW_STAT(_stats.moveLogicTime += utils::gettime() - startTime);
+#endif
+}
+
+void PageCenteredView::flushTouchMove()
+{
+    if (_pendingTouchMove.equals(Vec2::ZERO))
+    {
+        return;
+    }
+    Vec2 offset = _pendingTouchMove;
+    _pendingTouchMove = Vec2::ZERO;
+
+    // the moves of a frame may go both ways, the boundaries are checked against the resulting one
+    if (_direction == Direction::HORIZONTAL)
+    {
+        _touchMoveDirection = offset.x < 0 ? TouchDirection::LEFT : TouchDirection::RIGHT;
+    }
+    else
+    {
+        _touchMoveDirection = offset.y > 0 ? TouchDirection::UP : TouchDirection::DOWN;
+    }
+    if (!scrollPages(offset))
+    {
+        // pages held at a boundary don't lead the touch
+        _touchMovePredictionLead = 0.0f;
+    }
+}
+
+float PageCenteredView::predictTouchMoveLead(float delta)
+{
+    float lead = 0.0f;
+    if (_touchMovePrediction == TouchMovePrediction::LINEAR)
+    {
+        lead = calculateTouchMoveVelocity() * _touchMovePredictionHorizon;
+    }
+    else
+    {
+        float dt = _touchMoveSampleTimes[(_touchMoveSampleIdx + TOUCH_MOVE_SAMPLE_NUM - 1) % TOUCH_MOVE_SAMPLE_NUM];
+        _touchTrackPosition += delta;
+        if (dt > 0.0f)
+        {
+            float position = _touchFilterPosition + _touchFilterVelocity * dt;
+            float residual = _touchTrackPosition - position;
+            _touchFilterPosition = position + TOUCH_FILTER_ALPHA * residual;
+            _touchFilterVelocity += TOUCH_FILTER_BETA * residual / dt;
+        }
+        lead = _touchFilterPosition + _touchFilterVelocity * _touchMovePredictionHorizon - _touchTrackPosition;
+    }
+
+    // never lead by more than half a page
+    float maxLead = _slotGeometry.halfExtent;
+    return std::max(std::min(lead, maxLead), -maxLead);
+}
+
+void PageCenteredView::dropTouchMovePrediction()
+{
+    if (_direction == Direction::HORIZONTAL)
+    {
+        _pendingTouchMove.x -= _touchMovePredictionLead;
+    }
+    else
+    {
+        _pendingTouchMove.y -= _touchMovePredictionLead;
+    }
+    _touchMovePredictionLead = 0.0f;
+}
+
+void PageCenteredView::resetTouchMoveSamples()
+{
+    _touchMoveSampleNum = 0;
+    _touchMoveSampleIdx = 0;
+    _touchMovePreviousTime = utils::gettime();
+    _touchMovePredictionLead = 0.0f;
+    _touchTrackPosition = 0.0f;
+    _touchFilterPosition = 0.0f;
+    _touchFilterVelocity = 0.0f;
+}
+
+void PageCenteredView::gatherTouchMove(float delta)
+{
+    double time = utils::gettime();
+    _touchMoveSamples[_touchMoveSampleIdx] = delta;
+    _touchMoveSampleTimes[_touchMoveSampleIdx] = static_cast<float>(time - _touchMovePreviousTime);
+    _touchMoveSampleIdx = (_touchMoveSampleIdx + 1) % TOUCH_MOVE_SAMPLE_NUM;
+    if (_touchMoveSampleNum < TOUCH_MOVE_SAMPLE_NUM)
+    {
+        _touchMoveSampleNum++;
+    }
+    _touchMovePreviousTime = time;
+}
+
+float PageCenteredView::calculateTouchMoveVelocity()const
+{
+    if (_touchMoveSampleNum <= 0 || utils::gettime() - _touchMovePreviousTime > MAX_FLING_RELEASE_DELAY)
+    {
+        return 0.0f;
+    }
+    float totalDistance = 0.0f;
+    float totalTime = 0.0f;
+    for (int i = 0; i < _touchMoveSampleNum; i++)
+    {
+        totalDistance += _touchMoveSamples[i];
+        totalTime += _touchMoveSampleTimes[i];
+    }
+    if (totalTime <= 0.0f)
+    {
+        return 0.0f;
+    }
+    return totalDistance / totalTime;
+}
+
+bool PageCenteredView::startFling()
+{
+    float velocity = calculateTouchMoveVelocity();
+    if (fabs(velocity) < MIN_FLING_VELOCITY)
+    {
+        return false;
+    }
+
+    // project the friction stop point and land on the nearest page slot
+    float offset = getContentOffset();
+    float projectedOffset = offset + velocity * fabs(velocity) / (2.0f * _flingDeceleration);
+    ssize_t targetIdx = getPageIndexByContentOffset(projectedOffset);
+    if (!_circularEnabled)
+    {
+        targetIdx = std::min(std::max<ssize_t>(targetIdx, 0), this->getPageCount() - 1);
+    }
+    float distance = getContentOffsetByIndex(targetIdx) - offset;
+    if (targetIdx == getCenterPageIndex() || distance * velocity <= 0.0f)
+    {
+        return false;
+    }
+
+    // uniform deceleration from the release velocity which stops exactly at the slot
+    _curPageIdx = targetIdx;
+    startAutoScroll(getContentOffsetByIndex(targetIdx), 2.0f * distance / velocity, AutoScrollEasing::QUAD_OUT);
+    return true;
+}
+
+void PageCenteredView::setFlingEnabled(bool enabled)
+{
+    _flingEnabled = enabled;
+}
+
+bool PageCenteredView::isFlingEnabled()const
+{
+    return _flingEnabled;
+}
+
+void PageCenteredView::setTouchMoveCoalescingEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        flushTouchMove();
+    }
+    _touchMoveCoalescingEnabled = enabled;
+}
+
+bool PageCenteredView::isTouchMoveCoalescingEnabled()const
+{
+    return _touchMoveCoalescingEnabled;
+}
+
+void PageCenteredView::setTouchMovePrediction(TouchMovePrediction prediction, float horizon)
+{
+    if (prediction == TouchMovePrediction::NONE)
+    {
+        dropTouchMovePrediction();
+        flushTouchMove();
+    }
+    _touchMovePrediction = prediction;
+    _touchMovePredictionHorizon = std::max(horizon, 0.0f);
+}
+
+PageCenteredView::TouchMovePrediction PageCenteredView::getTouchMovePrediction()const
+{
+    return _touchMovePrediction;
+}
+
+float PageCenteredView::getTouchMovePredictionHorizon()const
+{
+    return _touchMovePredictionHorizon;
+}
+
+void PageCenteredView::setFlingDeceleration(float deceleration)
+{
+    CCASSERT(deceleration > 0, "Invalid deceleration!");
+    _flingDeceleration = deceleration;
+}
+
+float PageCenteredView::getFlingDeceleration()const
+{
+    return _flingDeceleration;
 }
     
 void PageCenteredView::setCustomScrollThreshold(float threshold)
@@ -646,127 +2838,124 @@ bool PageCenteredView::isUsingCustomScrollThreshold()const
 
 void PageCenteredView::handleReleaseLogic(Touch *touch)
 {
+    // the release is handled from where the last touch moves put the pages, without prediction
+    dropTouchMovePrediction();
+    flushTouchMove();
+    _isDragging = false;
     if (this->getPageCount() <= 0)
     {
         return;
     }
-    Widget* curPage = dynamic_cast<Widget*>(this->getPages().at(_curPageIdx));
-    if (curPage)
-    {
-        Vec2 curPagePos = curPage->getPosition();
-        ssize_t pageCount = this->getPageCount();
-        
-        auto contentSize = getContentSize();
-       
-        float moveBoundray = 0.0f;
-		int movedPages = 0;
-
-		if (_direction == Direction::HORIZONTAL)
-		{
-			moveBoundray = curPagePos.x - _leftBoundary;
-			movedPages = floor(moveBoundray / (contentSize.width / _pageNumShowed)) * (-1);
-		}
-		else if (_direction == Direction::VERTICAL)
-		{
-			moveBoundray = curPagePos.y - _leftBoundary;
-			movedPages = floor(moveBoundray / (contentSize.height / _pageNumShowed));
-		}
-
-		_curPageIdx += movedPages;
-		if (_curPageIdx < 0)
-		{
-			_curPageIdx = 0;
-		}
-		if (_curPageIdx >= pageCount)
-		{
-			_curPageIdx = pageCount - 1;
-		}
-		curPage = dynamic_cast<Widget*>(this->getPages().at(_curPageIdx));
-		if (!curPage)
-		{
-			return ;
-		}
-
-		curPagePos = curPage->getPosition();
-
-		float scrollDistance;
-        if (_direction == Direction::HORIZONTAL)
+    if (_flingEnabled && startFling())
+    {
+        return;
+    }
+    Vec2 curPagePos;
+    ssize_t pageCount = this->getPageCount();
+    
+    float moveBoundray = 0.0f;
+	int movedPages = 0;
+    // fractional slot at leftBoundary, pages may have different extents
+    double slot = getSlotByContentOffset(getContentOffset());
+
+	if (_direction == Direction::HORIZONTAL)
+	{
+		movedPages = floor(_curPageIdx - slot) * (-1);
+	}
+	else if (_direction == Direction::VERTICAL)
+	{
+		movedPages = floor(slot - _curPageIdx);
+	}
+
+	_curPageIdx += movedPages;
+	if (!_circularEnabled && _curPageIdx < 0)
+	{
+		_curPageIdx = 0;
+	}
+	if (!_circularEnabled && _curPageIdx >= pageCount)
+	{
+		_curPageIdx = pageCount - 1;
+	}
+	curPagePos = getPagePosition(_curPageIdx);
+
+	float scrollDistance;
+    float curPageOffset = getContentOffsetByIndex(_curPageIdx);
+    if (_direction == Direction::HORIZONTAL)
+    {
+        curPagePos.y = 0;
+        moveBoundray = getContentOffset() - curPageOffset;
+        scrollDistance = getPageExtent(_curPageIdx) * 0.5f;
+    }
+    else if(_direction == Direction::VERTICAL)
+    {
+        curPagePos.x = 0;
+        moveBoundray = getContentOffset() - curPageOffset;
+        scrollDistance  = getPageExtent(_curPageIdx) * 0.5f;
+    }
+
+    if (!_usingCustomScrollThreshold)
+    {
+        _customScrollThreshold = scrollDistance;
+    }
+    float boundary = _customScrollThreshold;
+    
+    if (_direction == Direction::HORIZONTAL)
+    {
+        if (moveBoundray <= -boundary)
         {
-            curPagePos.y = 0;
-            moveBoundray = curPagePos.x - _leftBoundary;
-            scrollDistance = contentSize.width / _pageNumShowed / 2.0;
+            if (!_circularEnabled && _curPageIdx >= pageCount-1)
+            {
+                scrollPages(curPagePos);
+            }
+            else
+            {
+                scrollToPage(_curPageIdx+1);
+            }
         }
-        else if(_direction == Direction::VERTICAL)
+        else if (moveBoundray >= boundary)
         {
-            curPagePos.x = 0;
-            moveBoundray = curPagePos.y - _leftBoundary;
-            scrollDistance  = contentSize.height / _pageNumShowed / 2.0;
+            if (!_circularEnabled && _curPageIdx <= 0)
+            {
+                scrollPages(curPagePos);
+            }
+            else
+            {
+                scrollToPage(_curPageIdx-1);
+            }
         }
-
-        if (!_usingCustomScrollThreshold)
+        else
         {
-            _customScrollThreshold = scrollDistance;
+            scrollToPage(_curPageIdx);
         }
-        float boundary = _customScrollThreshold;
-        
-        if (_direction == Direction::HORIZONTAL)
+    }
+    else if(_direction == Direction::VERTICAL)
+    {
+        if (moveBoundray >= boundary)
         {
-            if (moveBoundray <= -boundary)
-            {
-                if (_curPageIdx >= pageCount-1)
-                {
-                    scrollPages(curPagePos);
-                }
-                else
-                {
-                    scrollToPage(_curPageIdx+1);
-                }
-            }
-            else if (moveBoundray >= boundary)
+            if (!_circularEnabled && _curPageIdx >= pageCount-1)
             {
-                if (_curPageIdx <= 0)
-                {
-                    scrollPages(curPagePos);
-                }
-                else
-                {
-                    scrollToPage(_curPageIdx-1);
-                }
+                scrollPages(curPagePos);
             }
             else
             {
-                scrollToPage(_curPageIdx);
+                scrollToPage(_curPageIdx+1);
             }
         }
-        else if(_direction == Direction::VERTICAL)
+        else if (moveBoundray <= -boundary)
         {
-            if (moveBoundray >= boundary)
+            if (!_circularEnabled && _curPageIdx <= 0)
             {
-                if (_curPageIdx >= pageCount-1)
-                {
-                    scrollPages(curPagePos);
-                }
-                else
-                {
-                    scrollToPage(_curPageIdx+1);
-                }
-            }
-            else if (moveBoundray <= -boundary)
-            {
-                if (_curPageIdx <= 0)
-                {
-                    scrollPages(curPagePos);
-                }
-                else
-                {
-                    scrollToPage(_curPageIdx-1);
-                }
+                scrollPages(curPagePos);
             }
             else
             {
-                scrollToPage(_curPageIdx);
+                scrollToPage(_curPageIdx-1);
             }
         }
+        else
+        {
+            scrollToPage(_curPageIdx);
+        }
     }
 }
 
@@ -786,6 +2975,10 @@ void PageCenteredView::interceptTouchEvent(TouchEventType event, Widget *sender,
         {
             _touchBeganPosition = touch->getLocation();
             _isInterceptTouch = true;
+            _isAutoScrolling = false;
+            _isDragging = true;
+            _pendingTouchMove = Vec2::ZERO;
+            resetTouchMoveSamples();
         }
         break;
         case TouchEventType::MOVED:
@@ -823,6 +3016,7 @@ void PageCenteredView::interceptTouchEvent(TouchEventType event, Widget *sender,
 
 void PageCenteredView::pageTurningEvent()
 {
+    PAGECENTEREDVIEW_STAT(_stats.turningEvents++);
     this->retain();
     if (_pageViewEventListener && _pageViewEventSelector)
     {
@@ -836,9 +3030,141 @@ void PageCenteredView::pageTurningEvent()
     {
         _ccEventCallback(this, static_cast<int>(EventType::TURNING));
     }
+    if (hasPageEventListener(PageEventType::TURNING))
+    {
+        dispatchPageEvent({PageEventType::TURNING, getCurPageIndex(), nullptr, 0.0f});
+    }
     this->release();
 }
 
+float PageCenteredView::getScrollProgress() const
+{
+    double progress = getSlotByContentOffset(getContentOffset());
+    ssize_t pageCount = this->getPageCount();
+    if (_circularEnabled && pageCount > 0)
+    {
+        progress = fmod(progress, static_cast<double>(pageCount));
+        if (progress < 0)
+        {
+            progress += pageCount;
+        }
+    }
+    return static_cast<float>(progress);
+}
+
+void PageCenteredView::setScrollProgressDirty()
+{
+    if (!hasPageEventListener(PageEventType::SCROLL_PROGRESS))
+    {
+        return;
+    }
+    // moves of a frame are coalesced into one event, sent from update
+    _scrollProgressDirty = true;
+    scheduleAnimationUpdate();
+}
+
+void PageCenteredView::dispatchScrollProgress()
+{
+    if (!_scrollProgressDirty)
+    {
+        return;
+    }
+    _scrollProgressDirty = false;
+    float progress = getScrollProgress();
+    if (progress == _lastScrollProgress || !hasPageEventListener(PageEventType::SCROLL_PROGRESS))
+    {
+        return;
+    }
+    _lastScrollProgress = progress;
+    dispatchPageEvent({PageEventType::SCROLL_PROGRESS, -1, nullptr, progress});
+}
+
+bool PageCenteredView::hasPageEventListener(PageEventType type)const
+{
+    return _pageEventListenerCounts[static_cast<int>(type)] > 0;
+}
+
+void PageCenteredView::dispatchPageEvent(const PageEvent& event)
+{
+    // listeners are neither added nor destroyed while dispatching, so the callbacks stay in place
+    _pageEventDispatchDepth++;
+    for (size_t i = 0, count = _pageEventListeners.size(); i < count; i++)
+    {
+        const PageEventListener& listener = _pageEventListeners[i];
+        if (listener.id != 0 && listener.type == event.type)
+        {
+            listener.callback(this, event);
+        }
+    }
+    _pageEventDispatchDepth--;
+
+    if (_pageEventDispatchDepth == 0 && _pageEventListenersDirty)
+    {
+        _pageEventListeners.erase(std::remove_if(_pageEventListeners.begin(), _pageEventListeners.end(), [](const PageEventListener& listener) {
+            return listener.id == 0;
+        }), _pageEventListeners.end());
+        for (auto& listener : _addedPageEventListeners)
+        {
+            if (listener.id != 0)
+            {
+                _pageEventListeners.push_back(std::move(listener));
+            }
+        }
+        _addedPageEventListeners.clear();
+        _pageEventListenersDirty = false;
+    }
+}
+
+int PageCenteredView::addPageEventListener(PageEventType type, const ccPageEventCallback& callback)
+{
+    if (!callback)
+    {
+        return 0;
+    }
+    PageEventListener listener = {++_pageEventListenerId, type, callback};
+    _pageEventListenerCounts[static_cast<int>(type)]++;
+    if (_pageEventDispatchDepth > 0)
+    {
+        _addedPageEventListeners.push_back(listener);
+        _pageEventListenersDirty = true;
+    }
+    else
+    {
+        _pageEventListeners.push_back(listener);
+    }
+    return listener.id;
+}
+
+void PageCenteredView::removePageEventListener(int listenerId)
+{
+    if (listenerId <= 0)
+    {
+        return;
+    }
+    for (auto listeners : {&_pageEventListeners, &_addedPageEventListeners})
+    {
+        for (auto it = listeners->begin(); it != listeners->end(); ++it)
+        {
+            if (it->id != listenerId)
+            {
+                continue;
+            }
+            _pageEventListenerCounts[static_cast<int>(it->type)]--;
+            if (_pageEventDispatchDepth > 0)
+            {
+                // the callback may be running, it's destroyed when the dispatch ends
+                it->id = 0;
+                _pageEventListenersDirty = true;
+            }
+            else
+            {
+                listeners->erase(it);
+            }
+            return;
+        }
+    }
+}
+
 void PageCenteredView::addEventListenerPageView(Ref *target, SEL_PageCenteredViewEvent selector)
 {
     _pageViewEventListener = target;
@@ -852,7 +3178,7 @@ void PageCenteredView::addEventListener(const ccPageCenteredViewCallback& callba
 
 ssize_t PageCenteredView::getCurPageIndex() const
 {
-    return _curPageIdx;
+    return wrapPageIndex(_curPageIdx);
 }
 
 Vector<Layout*>& PageCenteredView::getPages()
@@ -862,11 +3188,11 @@ Vector<Layout*>& PageCenteredView::getPages()
     
 Layout* PageCenteredView::getPage(ssize_t index)
 {
-    if (index < 0 || index >= this->getPages().size())
+    if (index < 0 || index >= this->getPageCount())
     {
         return nullptr;
     }
-    return _pages.at(index);
+    return getLivePage(index);
 }
 
 std::string PageCenteredView::getDescription() const
@@ -882,6 +3208,14 @@ Widget* PageCenteredView::createCloneInstance()
 void PageCenteredView::copyClonedWidgetChildren(Widget* model)
 {
 	_pageNumShowed = static_cast<PageCenteredView*>(model)->_pageNumShowed;
+    // the cloned pages are added with the model's page size
+    updateSlotGeometry();
+    if (isVirtualized())
+    {
+        // live pages are rebuilt from the data source
+        reloadData();
+        return;
+    }
 
     auto modelPages = static_cast<PageCenteredView*>(model)->getPages();
 	for (auto& page : modelPages)
@@ -904,6 +3238,48 @@ void PageCenteredView::copySpecialProperties(Widget *widget)
         _customScrollThreshold = pageView->_customScrollThreshold;
         _direction = pageView->_direction;
 		_pageNumShowed = pageView->_pageNumShowed;
+        // the size was copied before the direction and the showed number
+        updateSlotGeometry();
+        _pageSizeDirty = true;
+        _contentOffsetDirty = true;
+        setPagesPositionDirty(0);
+        _pageCountCallback = pageView->_pageCountCallback;
+        _configurePageCallback = pageView->_configurePageCallback;
+        _livePageMargin = pageView->_livePageMargin;
+        _circularEnabled = pageView->_circularEnabled;
+        _pageExtentCallback = pageView->_pageExtentCallback;
+        _pageExtentsDirty = true;
+        _pageCullingEnabled = pageView->_pageCullingEnabled;
+        _pageEffectEnabled = pageView->_pageEffectEnabled;
+        _pageEffectScale = pageView->_pageEffectScale;
+        _pageEffectOpacity = pageView->_pageEffectOpacity;
+        _pageEffectRotation = pageView->_pageEffectRotation;
+        _pageEffectRange = pageView->_pageEffectRange;
+        _statsEnabled = pageView->_statsEnabled;
+        _pageTexturesCallback = pageView->_pageTexturesCallback;
+        _pageContentCallback = pageView->_pageContentCallback;
+        _prefetchMargin = pageView->_prefetchMargin;
+        _prefetchAhead = pageView->_prefetchAhead;
+        _evictBehind = pageView->_evictBehind;
+        _prefetchLookaheadTime = pageView->_prefetchLookaheadTime;
+        _pageWillAppearCallback = pageView->_pageWillAppearCallback;
+        _pageDidDisappearCallback = pageView->_pageDidDisappearCallback;
+        for (const auto& listener : pageView->_pageEventListeners)
+        {
+            if (listener.id != 0)
+            {
+                addPageEventListener(listener.type, listener.callback);
+            }
+        }
+        _autoScrollEasing = pageView->_autoScrollEasing;
+        _autoScrollDuration = pageView->_autoScrollDuration;
+        _flingEnabled = pageView->_flingEnabled;
+        _touchMoveCoalescingEnabled = pageView->_touchMoveCoalescingEnabled;
+        _touchMovePrediction = pageView->_touchMovePrediction;
+        _touchMovePredictionHorizon = pageView->_touchMovePredictionHorizon;
+        _flingDeceleration = pageView->_flingDeceleration;
+        _pagePlaceholderCallback = pageView->_pagePlaceholderCallback;
+        _pageBuildBudget = pageView->_pageBuildBudget;
     }
 }
 
@@ -25,9 +25,19 @@ THE SOFTWARE.
 #ifndef __UIPAGECENTEREDVIEW_H__
 #define __UIPAGECENTEREDVIEW_H__
 
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 #include "ui/UILayout.h"
 #include "ui/GUIExport.h"
 
+/**
+ * Set to 0 to compile the PageCenteredView instrumentation counters out.
+ */
+#ifndef CC_PAGECENTEREDVIEW_STATS
+#define CC_PAGECENTEREDVIEW_STATS 1
+#endif
+
 /**
  * @addtogroup ui
  * @{
@@ -86,12 +96,115 @@ public:
         HORIZONTAL,
         VERTICAL
     };
+
+    /**
+     * Easing curve of the page auto scrolling.
+     */
+    enum class AutoScrollEasing
+    {
+        LINEAR,
+        QUAD_OUT,
+        CUBIC_OUT,
+        SPRING,
+        CRITICALLY_DAMPED
+    };
+
+    /**
+     * Prediction of the touch position while dragging.
+     * LINEAR extrapolates the average velocity of the latest touch moves,
+     * ALPHA_BETA tracks the finger with an alpha-beta filter, a steady state Kalman filter.
+     */
+    enum class TouchMovePrediction
+    {
+        NONE,
+        LINEAR,
+        ALPHA_BETA
+    };
+
+    /**
+     * Page mutations posted to the mutation queue.
+     */
+    enum class PageMutationType
+    {
+        INSERT,
+        REMOVE
+    };
     
     /**
      *PageView page turn event callback.
      */
     typedef std::function<void(Ref*,EventType)> ccPageCenteredViewCallback;
 
+    /**
+     * Page event types of the event listeners.
+     */
+    enum class PageEventType
+    {
+        TURNING,
+        SCROLL_PROGRESS,
+        PAGE_WILL_APPEAR,
+        PAGE_DID_DISAPPEAR
+    };
+
+    /**
+     * Page event passed to the event listeners.
+     */
+    struct PageEvent
+    {
+        PageEventType type;
+        /** Page index, of TURNING, PAGE_WILL_APPEAR and PAGE_DID_DISAPPEAR events. */
+        ssize_t pageIdx;
+        /** Page of PAGE_WILL_APPEAR and PAGE_DID_DISAPPEAR events. */
+        Layout* page;
+        /** Fractional page index showed at the center slot, of SCROLL_PROGRESS events. */
+        float progress;
+    };
+
+    /**
+     *Page event listener callback.
+     */
+    typedef std::function<void(PageCenteredView*, const PageEvent&)> ccPageEventCallback;
+
+    /**
+     *Data source callback which returns the page count of a virtualized PageView.
+     */
+    typedef std::function<ssize_t()> ccPageCountCallback;
+
+    /**
+     *Data source callback which binds the content of a page index to a recycled page.
+     */
+    typedef std::function<void(Layout*, ssize_t)> ccConfigurePageCallback;
+
+    /**
+     *Async page loader callback which returns the image files a page index needs.
+     */
+    typedef std::function<std::vector<std::string>(ssize_t)> ccPageTexturesCallback;
+
+    /**
+     *Async page loader callback which builds the content of a page once its textures are cached.
+     */
+    typedef std::function<void(Layout*, ssize_t)> ccPageContentCallback;
+
+    /**
+     *Callback notified when a page enters or leaves the prefetch window.
+     */
+    typedef std::function<void(Layout*, ssize_t)> ccPageAppearanceCallback;
+
+    /**
+     *Callback which returns the size of a page index along the scroll direction.
+     */
+    typedef std::function<float(ssize_t)> ccPageExtentCallback;
+
+    /**
+     *Callback which creates the page of a new item key.
+     */
+    typedef std::function<Layout*(const std::string&)> ccCreateItemPageCallback;
+
+    /**
+     *Callback which builds the content of a deferred page, or of its placeholder.
+     */
+    typedef std::function<void(Layout*)> ccBuildPageCallback;
+
     /**
      * Default constructor
      * @js ctor
@@ -135,6 +248,59 @@ public:
      * @param idx   A given index.
      */
     void insertPage(Layout* page, int idx);
+
+    /**
+     * Insert a range of pages into PageView at a given index.
+     * The pages are inserted in one pass and trigger a single relayout,
+     * null pages and pages already in PageView are skipped.
+     *
+     * @param pages Pages to be inserted.
+     * @param idx   A given index, pages are appended if it's beyond the page count.
+     */
+    void insertPages(const Vector<Layout*>& pages, ssize_t idx);
+
+    /**
+     * Replace all the pages of PageView.
+     * Pages kept from the old set are reused as is, the others are removed,
+     * and the whole change triggers a single relayout.
+     *
+     * @param pages New pages of PageView.
+     */
+    void setPages(const Vector<Layout*>& pages);
+
+    /**
+     * Replace the pages by the pages of a list of item keys.
+     * Pages of the keys already showed are reused, only the pages of new keys are created
+     * and the pages of dropped keys removed. The item showed at the center, or the nearest
+     * item kept, stays at the center, and the whole change triggers a single relayout.
+     *
+     * @param itemIds         Keys of the items in their new order, repeated keys are skipped.
+     * @param createItemPage  Callback creating the page of a new key.
+     */
+    void applyItems(const std::vector<std::string>& itemIds, const ccCreateItemPageCallback& createItemPage);
+
+    /**
+     * Attach a queue of page mutations which can be posted from any thread.
+     * Mutations are applied in order at the start of the update, at most maxPerFrame of them a frame.
+     * Call it from the main thread, before any mutation is posted. Replacing or detaching the queue
+     * requires that no thread posts meanwhile, a post racing with it may touch the released cells.
+     *
+     * @param createItemPage Callback creating the page of an inserted key, called on the main thread.
+     * @param capacity       Number of mutations the queue holds, rounded up to a power of two, 0 to detach the queue.
+     * @param maxPerFrame    Maximum number of mutations applied a frame.
+     */
+    void setPageMutationQueue(const ccCreateItemPageCallback& createItemPage, int capacity = 256, int maxPerFrame = 16);
+
+    /**
+     * Post a page mutation to the mutation queue, it's lock free and can be called from any thread.
+     * The current page stays at the center while pages are inserted or removed before it.
+     *
+     * @param type   INSERT to add the page of a new key, REMOVE to remove the page of a key.
+     * @param itemId Key of the item.
+     * @param idx    Index an inserted page is placed at, -1 to append it.
+     * @return False if the queue is full or not attached, the mutation is dropped then.
+     */
+    bool postPageMutation(PageMutationType type, const std::string& itemId, ssize_t idx = -1);
     
     /**
      * Remove a page of PageView.
@@ -171,6 +337,185 @@ public:
 	void setShowedNum(int val);
 	int getShowedNum() const;
     
+    /**
+     * Load the page contents asynchronously.
+     * Pages show their placeholder content until they enter the prefetch window around the showed pages.
+     * The textures returned by `pageTextures` are then decoded by the texture cache loading thread,
+     * and `pageContent` is called on the main thread to swap the real content in once they are all cached.
+     * In virtualized mode, a recycled page is loaded again after `configurePage` bound its placeholder.
+     * Pass a nullptr `pageContent` to stop loading pages.
+     *
+     * @param pageTextures   Callback returning the image files of a page index, may be nullptr.
+     * @param pageContent    Callback building the content of a page.
+     * @param prefetchMargin Number of pages loaded ahead on each side of the showed pages.
+     */
+    void setAsyncPageLoader(const ccPageTexturesCallback& pageTextures, const ccPageContentCallback& pageContent, int prefetchMargin = 1);
+
+    /**
+     * Add a page whose content is built later, within the build budget of a frame.
+     * The page shows its placeholder until then, pages nearest the current page are built first.
+     *
+     * @param build Callback building the content of the page.
+     * @param idx   Index the page is inserted at, -1 to append it.
+     * @return The page added, nullptr in virtualized mode.
+     */
+    Layout* addDeferredPage(const ccBuildPageCallback& build, ssize_t idx = -1);
+
+    /**
+     * Set the callback filling a deferred page with its placeholder content.
+     * The placeholder children are removed before the page is built.
+     *
+     * @param placeholder Callback building the placeholder, nullptr for empty pages.
+     */
+    void setDeferredPagePlaceholder(const ccBuildPageCallback& placeholder);
+
+    /**
+     * Set the time deferred pages may be built in each frame, at least one page is built a frame.
+     *
+     * @param budget Time in seconds, 0.002 by default.
+     */
+    void setPageBuildBudget(float budget);
+
+    /**
+     * Query the time deferred pages may be built in each frame.
+     * @return Time in seconds.
+     */
+    float getPageBuildBudget()const;
+
+    /**
+     * Configure how the prefetch window follows the scrolling.
+     * The window reaches `aheadPages` pages ahead of the motion, plus the pages travelled in
+     * `lookaheadTime` seconds at the current scroll speed, and `prefetchMargin` pages behind it.
+     * Pages farther than `evictBehindPages` from the showed pages and outside the window are evicted,
+     * they are loaded again when they come back. In virtualized mode an evicted page is bound to its
+     * placeholder again through `configurePage`. Otherwise the page keeps its content: the did disappear
+     * callback must unload it, and `pageContent` must clear the page before building into it.
+     *
+     * @param aheadPages       Number of pages loaded ahead of the motion.
+     * @param evictBehindPages Distance from the showed pages beyond which pages are evicted, negative to never evict.
+     * @param lookaheadTime    Seconds of motion the window anticipates.
+     */
+    void setPrefetchPolicy(int aheadPages, int evictBehindPages = -1, float lookaheadTime = 0.0f);
+
+    /**
+     * Set the callbacks notified when a page enters the prefetch window, before it's loaded,
+     * and when it's evicted or recycled.
+     *
+     * @param willAppear   Callback called when a page will appear.
+     * @param didDisappear Callback called when a page did disappear.
+     */
+    void setPageAppearanceCallbacks(const ccPageAppearanceCallback& willAppear, const ccPageAppearanceCallback& didDisappear);
+
+    /**
+     * Enable or disable culling of the pages outside the showed area.
+     * Culled pages are set invisible so they aren't visited nor sent to the clipping pass,
+     * only the showed pages and one page on each side of them are kept visible.
+     * Culling is enabled by default. PageView owns the visibility of its pages then,
+     * hide the content of a page rather than the page itself. Pages leaving PageView are made visible again.
+     *
+     * @param enabled True to cull the offscreen pages, false otherwise.
+     */
+    void setPageCullingEnabled(bool enabled);
+
+    /**
+     * Query whether the offscreen pages are culled.
+     * @return True if page culling is enabled, false otherwise.
+     */
+    bool isPageCullingEnabled()const;
+
+    /**
+     * Enable or disable the circular mode.
+     * In circular mode the last page is followed by the first one, pages leaving one end of the view
+     * are moved to the other end and scrollToPage takes the shortest way round.
+     * It needs at least getShowedNum() + 2 pages to fill the view.
+     *
+     * @param enabled True to scroll round the pages, false to stop at the first and last page.
+     */
+    void setCircularEnabled(bool enabled);
+
+    /**
+     * Query whether the circular mode is enabled.
+     * @return True if the pages are scrolled round, false otherwise.
+     */
+    bool isCircularEnabled()const;
+
+    /**
+     * Enable or disable the page effect.
+     * When enabled the pages are scaled, faded and tilted by their distance to the center slot,
+     * following the curve set by setPageEffect. Disabled by default.
+     * PageView owns the anchor point, scale, opacity and rotation of its pages while enabled,
+     * they are reset when it's disabled or when a page leaves PageView.
+     *
+     * @param enabled True to apply the page effect, false otherwise.
+     */
+    void setPageEffectEnabled(bool enabled);
+
+    /**
+     * Query whether the page effect is enabled.
+     * @return True if the page effect is applied, false otherwise.
+     */
+    bool isPageEffectEnabled()const;
+
+    /**
+     * Set the curve of the page effect.
+     * The centered page is unchanged, the effect grows linearly with the distance to the center slot
+     * and reaches the given values `range` slots away from it.
+     *
+     * @param edgeScale    Scale of the pages `range` slots away.
+     * @param edgeOpacity  Opacity of the pages `range` slots away, from 0 to 255.
+     * @param edgeRotation Tilt in degrees of the pages `range` slots away, around the axis across the scroll direction.
+     * @param range        Distance in slots where the effect is complete.
+     */
+    void setPageEffect(float edgeScale, float edgeOpacity, float edgeRotation, float range = 1.0f);
+
+    /**
+     * Instrumentation counters accumulated since the last `resetStats`.
+     */
+    struct Stats
+    {
+        /** Pages moved inside the inner container. */
+        unsigned int pagesRepositioned;
+        /** Calls to setPosition on the pages and the inner container. */
+        unsigned int setPositionCalls;
+        /** Layout passes run because the layout was dirty. */
+        unsigned int layoutPasses;
+        /** Moves clamped at the first or last page. */
+        unsigned int boundaryClamps;
+        /** Dispatched page turning events. */
+        unsigned int turningEvents;
+        /** Seconds spent handling touch moves. */
+        double moveLogicTime;
+        /** Seconds spent in auto scroll steps. */
+        double autoScrollTime;
+    };
+
+    /**
+     * Enable or disable the instrumentation counters, disabled by default.
+     * Counting costs a single branch when disabled and nothing when CC_PAGECENTEREDVIEW_STATS is 0.
+     *
+     * @param enabled True to count, false otherwise.
+     */
+    void setStatsEnabled(bool enabled);
+
+    /**
+     * Query whether the instrumentation counters are enabled.
+     *
+     * @return True if counting, false otherwise.
+     */
+    bool isStatsEnabled()const;
+
+    /**
+     * Get the instrumentation counters, typically read and reset once per frame.
+     *
+     * @return The counters accumulated since the last reset.
+     */
+    const Stats& getStats()const;
+
+    /**
+     * Reset all the instrumentation counters to zero.
+     */
+    void resetStats();
+
     /**
      * @brief Remove all pages of the PageView.
      */
@@ -190,6 +535,14 @@ public:
      */
     ssize_t getCurPageIndex() const;
 
+    /**
+     * Gets the fractional index of the page showed at the center slot.
+     * It follows the scrolling continuously, 2.5 means halfway between the pages 2 and 3.
+     * PageEventType::SCROLL_PROGRESS listeners receive it at most once per frame.
+     * @return The scroll progress in pages.
+     */
+    float getScrollProgress() const;
+
     /**
      * Jump to a page with a given index without scrolling.
      * This is the different between scrollToPage.
@@ -200,6 +553,8 @@ public:
      
     /**
      * @brief Get all the pages in the PageView.
+     * In virtualized mode only the live pages are returned, ordered by page index.
+     * Pages are children of an inner container, so their positions are relative to it.
      * @return A vector of Layout pointers.
      */
     Vector<Layout*>& getPages();
@@ -209,10 +564,49 @@ public:
      * @brief Get a page at a given index
      *
      * @param index A given index.
-     * @return A layout pointer in PageView container.
+     * @return A layout pointer in PageView container, nullptr if the page isn't alive in virtualized mode.
      */
     Layout* getPage(ssize_t index);
     
+    /**
+     * Switch PageView to virtualized mode.
+     * Only `showedNum + 2 * margin` pages are kept alive, they are recycled and rebound
+     * through `configurePage` while the view scrolls, like the cells of a table view.
+     * Pages can't be added or removed by hand in this mode, pass nullptr callbacks to leave it.
+     *
+     * @param pageCount     Callback returning the number of pages.
+     * @param configurePage Callback binding a page index to a recycled page.
+     * @param margin        Number of pages kept alive on each side of the showed pages.
+     */
+    void setDataSource(const ccPageCountCallback& pageCount, const ccConfigurePageCallback& configurePage, int margin = 1);
+
+    /**
+     * Query whether the pages are supplied by a data source.
+     * @return True if PageView is virtualized, false otherwise.
+     */
+    bool isVirtualized()const;
+
+    /**
+     * Query the page count from the data source again and rebind all the live pages.
+     */
+    void reloadData();
+
+    /**
+     * Give the pages their own size along the scroll direction, the other side still fills the PageView.
+     * Extents are kept in prefix sums, so finding the page at an offset takes O(log n) however sizes vary.
+     * Pages are snapped by their leading edge to the slot of the current page.
+     *
+     * @param pageExtent Callback returning the extent of a page index, nullptr for pages of `size / showedNum`.
+     */
+    void setPageExtentCallback(const ccPageExtentCallback& pageExtent);
+
+    /**
+     * Query the extent of one page from the callback again, in O(log n).
+     *
+     * @param idx A given page index.
+     */
+    void updatePageExtent(ssize_t idx);
+
     /**
      * Add a page turn callback to PageView, then when one page is turning, the callback will be called.
      *@deprecated Use `PageView::addEventListener` instead.
@@ -228,6 +622,23 @@ public:
      * @param callback A page turning callback.
      */
     void addEventListener(const ccPageCenteredViewCallback& callback);
+
+    /**
+     * Add a listener of a page event type, any number of listeners can be added.
+     * Events are dispatched without allocating, listeners of continuous events must not release the PageView.
+     *
+     * @param type     The page event type listened to.
+     * @param callback The callback called with the event.
+     * @return An id to remove the listener with.
+     */
+    int addPageEventListener(PageEventType type, const ccPageEventCallback& callback);
+
+    /**
+     * Remove a page event listener, it can be removed from its own callback.
+     *
+     * @param listenerId The id returned by addPageEventListener.
+     */
+    void removePageEventListener(int listenerId);
     
     //override methods
     virtual bool onTouchBegan(Touch *touch, Event *unusedEvent) override;
@@ -242,6 +653,7 @@ public:
      * @lua NA
      */
     virtual void onEnter() override;
+    virtual void cleanup() override;
 
     /**   
      *@brief If you don't specify the value, the pageView will turn page when scrolling at the half width of a page.
@@ -268,23 +680,174 @@ public:
      */
     bool isUsingCustomScrollThreshold()const;
 
+    /**
+     *@brief Set the easing curve used when scrolling to a page.
+     * The scroll offset is evaluated from the elapsed time, so the animation lasts the same duration at any frame rate.
+     *@param easing An easing curve, `AutoScrollEasing::LINEAR` by default.
+     */
+    void setAutoScrollEasing(AutoScrollEasing easing);
+
+    /**
+     *@brief Query the easing curve used when scrolling to a page.
+     *@return The easing curve.
+     */
+    AutoScrollEasing getAutoScrollEasing()const;
+
+    /**
+     *@brief Set the duration of scrolling to a page.
+     *@param duration Duration in seconds, 0.2 by default.
+     */
+    void setAutoScrollDuration(float duration);
+
+    /**
+     *@brief Query the duration of scrolling to a page.
+     *@return Duration in seconds.
+     */
+    float getAutoScrollDuration()const;
+
+    /**
+     *@brief Enable or disable fling scrolling.
+     * When enabled, a fast release keeps the pages moving with the touch velocity and decelerates
+     * across several pages, landing exactly on a page slot. Slow releases still turn one page.
+     *@param enabled True to enable fling scrolling, false otherwise.
+     */
+    void setFlingEnabled(bool enabled);
+
+    /**
+     *@brief Query whether fling scrolling is enabled.
+     *@return True if fling scrolling is enabled, false otherwise.
+     */
+    bool isFlingEnabled()const;
+
+    /**
+     *@brief Set the friction deceleration used to project how far a fling goes.
+     *@param deceleration A deceleration in points per second squared.
+     */
+    void setFlingDeceleration(float deceleration);
+
+    /**
+     *@brief Query the friction deceleration of fling scrolling.
+     *@return Deceleration in points per second squared.
+     */
+    float getFlingDeceleration()const;
+
+    /**
+     *@brief Enable or disable coalescing of touch moves.
+     * When enabled, the touch moves received during a frame are accumulated and the pages
+     * are scrolled once per frame, in update, before the frame is drawn.
+     *@param enabled True to coalesce touch moves, false to scroll on every touch move.
+     */
+    void setTouchMoveCoalescingEnabled(bool enabled);
+
+    /**
+     *@brief Query whether touch moves are coalesced.
+     *@return True if touch moves are coalesced, false otherwise.
+     */
+    bool isTouchMoveCoalescingEnabled()const;
+
+    /**
+     *@brief Set how the pages lead the finger while dragging.
+     * The pages are moved to where the finger is expected to be `horizon` seconds after the touch move,
+     * the prediction is corrected on every touch move and dropped on release.
+     *@param prediction The predictor, TouchMovePrediction::NONE to follow the touch moves exactly.
+     *@param horizon    How far ahead the touch position is predicted, in seconds.
+     */
+    void setTouchMovePrediction(TouchMovePrediction prediction, float horizon);
+
+    /**
+     *@brief Query the predictor of the touch position.
+     *@return A TouchMovePrediction value.
+     */
+    TouchMovePrediction getTouchMovePrediction()const;
+
+    /**
+     *@brief Query how far ahead the touch position is predicted.
+     *@return Horizon in seconds.
+     */
+    float getTouchMovePredictionHorizon()const;
+
 CC_CONSTRUCTOR_ACCESS:
     virtual bool init() override;
 
 protected:
+    virtual void initRenderer() override;
 
     Layout* createPage();
     float getPositionXByIndex(ssize_t idx)const;
     float getPositionYByIndex(ssize_t idx)const;
     ssize_t getPageCount()const;
+    Layout* getLivePage(ssize_t idx)const;
+    ssize_t getLivePageSlot(ssize_t liveIdx)const;
+    ssize_t getFirstLivePageIndex(ssize_t centerIdx)const;
+    ssize_t wrapPageIndex(ssize_t idx)const;
+    ssize_t getNearestPageSlot(ssize_t idx)const;
+    void rebaseCircularSlots();
+    const Size& getPageSize()const;
+    void updateSlotGeometry();
+    Vec2 getPagePosition(ssize_t idx)const;
+    Vec2 getPageLayoutPosition(ssize_t idx)const;
+    Size getPageSizeByIndex(ssize_t idx)const;
+    float getPageExtent(ssize_t idx)const;
+    double getPageStart(ssize_t idx)const;
+    double getPageExtentPrefix(ssize_t count)const;
+    double getSlotByDistance(double distance)const;
+    double getPageDistanceFromOrigin(ssize_t idx)const;
+    void rebaseLayoutOrigin(ssize_t originIdx);
+    void rebuildPageExtents();
+    void splicePageExtents(ssize_t idx, ssize_t removedCount, ssize_t insertedCount);
+    void updatePageExtentTree(ssize_t fromIdx);
+    void moveContentOffset(double offset);
 
     void updateBoundaryPages();
+    bool updateLivePages(ssize_t centerIdx);
+    void recycleLivePages();
+    ssize_t getCenterPageIndex()const;
+    float getContentOffset()const;
+    double getContentOffsetByIndex(ssize_t idx)const;
+    ssize_t getPageIndexByContentOffset(float offset)const;
+    double getSlotByContentOffset(float offset)const;
+    void updateVisiblePages(bool forceUpdate);
+    void updatePageEffects();
+    void resetPageEffects();
+    void resetPageEffect(Layout* page);
+    void configureLivePage(Layout* page, ssize_t idx);
+    void forgetPage(Layout* page);
+    int getScrollIndexDirection()const;
+    float getScrollSpeed()const;
+    void updatePageLoading(bool forceUpdate);
+    void evictPages(ssize_t keepFirstIdx, ssize_t keepLastIdx);
+    void requestPageLoad(ssize_t idx);
+    void finishPageLoad(Layout* page, unsigned int requestId);
     virtual bool scrollPages(Vec2 touchOffset);
     void movePages(Vec2 offset);
     void pageTurningEvent();
+    bool hasPageEventListener(PageEventType type)const;
+    void dispatchPageEvent(const PageEvent& event);
+    void setScrollProgressDirty();
+    void dispatchScrollProgress();
+    void notifyPageWillAppear(Layout* page, ssize_t idx);
+    void notifyPageDidDisappear(Layout* page, ssize_t idx);
+    void applyPageMutation(PageMutationType type, const std::string& itemId, ssize_t idx);
+    ssize_t getMutatedPageSlot(ssize_t slot, ssize_t mutatedIdx, ssize_t pageCount, bool inserted)const;
     void updateAllPagesSize();
     void updateAllPagesPosition();
+    void updatePagesPosition(ssize_t fromIdx);
+    void updateContentOffset();
+    void setPagesPositionDirty(ssize_t fromIdx);
+    void drainPageMutations();
+    void buildDeferredPages();
     void autoScroll(float dt);
+    void startAutoScroll(double targetOffset, float duration, AutoScrollEasing easing);
+    void scheduleAnimationUpdate();
+    void unscheduleAnimationUpdate();
+
+    void resetTouchMoveSamples();
+    void gatherTouchMove(float delta);
+    float calculateTouchMoveVelocity()const;
+    bool startFling();
+    void flushTouchMove();
+    float predictTouchMoveLead(float delta);
+    void dropTouchMovePrediction();
 
     virtual void handleMoveLogic(Touch *touch) ;
     virtual void handleReleaseLogic(Touch *touch) ;
@@ -307,13 +870,119 @@ protected:
         DOWN
     };
     bool _isAutoScrolling;
-    float _autoScrollDistance;
-    float _autoScrollSpeed;
+    // update is only scheduled while an animation is running
+    bool _isUpdateScheduled;
     AutoScrollDirection _autoScrollDirection;
+    AutoScrollEasing _autoScrollEasing;
+    float _autoScrollDuration;
+    // running auto scroll, evaluated from the elapsed time
+    double _autoScrollStartOffset;
+    double _autoScrollTargetOffset;
+    float _autoScrollElapsed;
+    float _autoScrollTotalTime;
+    AutoScrollEasing _autoScrollCurve;
     Direction _direction;
     
     ssize_t _curPageIdx;
     Vector<Layout*> _pages;
+    std::unordered_set<Layout*> _pageSet;
+    // item keys of the pages added by applyItems or the mutation queue, and the pages by key
+    std::unordered_map<Layout*, std::string> _pageItemIds;
+    std::unordered_map<std::string, Layout*> _itemPages;
+
+    // virtualized mode, _pages holds the live pages [_firstLivePageIdx, _firstLivePageIdx + _pages.size()).
+    // In circular mode indices are slots, a slot shows the page of index slot modulo the page count
+    ccPageCountCallback _pageCountCallback;
+    ccConfigurePageCallback _configurePageCallback;
+    ssize_t _virtualPageCount;
+    ssize_t _firstLivePageIdx;
+    int _livePageMargin;
+    // the live pages are bound again on the next layout, the data or the index wrapping changed
+    bool _livePagesDirty;
+    bool _circularEnabled;
+
+    // pages are children of the inner container, scrolling only translates the container.
+    // They are laid out from the leading edge of _layoutOriginIdx, which is moved along with the
+    // pages, so the float positions of the container and the showed pages always stay small
+    Layout* _innerContainer;
+    ssize_t _layoutOriginIdx;
+
+    // live pages in [_visibleFirstIdx, _visibleLastIdx] are visible, others are culled
+    bool _pageCullingEnabled;
+    ssize_t _visibleFirstIdx;
+    ssize_t _visibleLastIdx;
+    std::vector<Layout*> _visiblePages;
+    std::vector<Layout*> _lastVisiblePages;
+    // after the layout origin is moved with culling, only the live pages in
+    // [_positionedFirstIdx, _positionedLastIdx] are laid out from it, the others when they're showed
+    bool _pagesPositionStale;
+    ssize_t _positionedFirstIdx;
+    ssize_t _positionedLastIdx;
+
+    bool _pageEffectEnabled;
+    float _pageEffectScale;
+    float _pageEffectOpacity;
+    float _pageEffectRotation;
+    float _pageEffectRange;
+    // page effect inputs and outputs, evaluated in one pass over the affected pages
+    std::vector<Layout*> _effectPages;
+    std::vector<float> _effectDistances;
+    std::vector<float> _effectScales;
+    std::vector<float> _effectOpacities;
+    std::vector<float> _effectRotations;
+
+    bool _statsEnabled;
+    Stats _stats;
+
+    // positions of the pages from _dirtyPageIdx are stale, -1 if none
+    ssize_t _dirtyPageIdx;
+    bool _pageSizeDirty;
+    bool _contentOffsetDirty;
+
+    // async page loading, keyed by page so recycled or removed pages drop their stale requests
+    struct PageLoadInfo
+    {
+        ssize_t idx;
+        unsigned int requestId;
+        ssize_t pendingTextures;
+        bool loaded;
+    };
+    ccPageTexturesCallback _pageTexturesCallback;
+    ccPageContentCallback _pageContentCallback;
+    int _prefetchMargin;
+    ssize_t _pageLoadCenterIdx;
+    unsigned int _pageLoadRequestId;
+    std::unordered_map<Layout*, PageLoadInfo> _pageLoadInfos;
+    int _prefetchAhead;
+    int _evictBehind;
+    float _prefetchLookaheadTime;
+    ccPageAppearanceCallback _pageWillAppearCallback;
+    ccPageAppearanceCallback _pageDidDisappearCallback;
+    std::vector<std::pair<Layout*, PageLoadInfo>> _evictedPages;
+
+    bool _flingEnabled;
+    bool _touchMoveCoalescingEnabled;
+    // touch moves accumulated until the next update, and whether a touch is in progress
+    Vec2 _pendingTouchMove;
+    bool _isDragging;
+
+    TouchMovePrediction _touchMovePrediction;
+    float _touchMovePredictionHorizon;
+    // distance the pages lead the real touch position by
+    float _touchMovePredictionLead;
+    // alpha-beta filter state along the scroll direction
+    float _touchTrackPosition;
+    float _touchFilterPosition;
+    float _touchFilterVelocity;
+    float _flingDeceleration;
+
+    // ring buffer of the latest touch move deltas along the scroll direction
+    static const int TOUCH_MOVE_SAMPLE_NUM = 5;
+    float _touchMoveSamples[TOUCH_MOVE_SAMPLE_NUM];
+    float _touchMoveSampleTimes[TOUCH_MOVE_SAMPLE_NUM];
+    int _touchMoveSampleNum;
+    int _touchMoveSampleIdx;
+    double _touchMovePreviousTime;
 
     TouchDirection _touchMoveDirection;
    
@@ -323,8 +992,28 @@ protected:
 	// odd number, for symmetry
 	int _pageNumShowed;
     
-    float _leftBoundary;
-    float _rightBoundary;
+    // slot geometry, recomputed only when the size, the showed number or the direction changes
+    struct SlotGeometry
+    {
+        Size pageSize;
+        // page size and boundaries along the scroll direction
+        float extent;
+        float halfExtent;
+        float invExtent;
+        float leftBoundary;
+        float rightBoundary;
+
+        SlotGeometry() : extent(0.0f), halfExtent(0.0f), invExtent(0.0f), leftBoundary(0.0f), rightBoundary(0.0f) {}
+    };
+    SlotGeometry _slotGeometry;
+
+    // variable page extents, _pageExtentTree is a 1-based Fenwick tree over _pageExtents,
+    // both are empty when the pages are uniform
+    ccPageExtentCallback _pageExtentCallback;
+    bool _pageExtentsDirty;
+    std::vector<float> _pageExtents;
+    std::vector<double> _pageExtentTree;
+    double _totalPageExtent;
     float _customScrollThreshold;
     bool _usingCustomScrollThreshold;
 
@@ -344,6 +1033,52 @@ protected:
 #pragma warning (pop)
 #endif
     ccPageCenteredViewCallback _eventCallback;
+
+    struct PageEventListener
+    {
+        // 0 once removed
+        int id;
+        PageEventType type;
+        ccPageEventCallback callback;
+    };
+    static const int PAGE_EVENT_TYPE_NUM = 4;
+    std::vector<PageEventListener> _pageEventListeners;
+    // listeners added while dispatching, appended when the dispatch ends
+    std::vector<PageEventListener> _addedPageEventListeners;
+    int _pageEventListenerCounts[PAGE_EVENT_TYPE_NUM];
+    int _pageEventListenerId;
+    int _pageEventDispatchDepth;
+    bool _pageEventListenersDirty;
+    // the progress is dispatched once per frame, when it has changed
+    bool _scrollProgressDirty;
+    float _lastScrollProgress;
+
+    struct PageMutation
+    {
+        PageMutationType type;
+        std::string itemId;
+        ssize_t idx;
+    };
+    // bounded multi-producer single-consumer queue, a cell is free to post at the enqueue
+    // position equal to its sequence, and ready to drain when its sequence is one past it
+    struct PageMutationCell
+    {
+        std::atomic<size_t> sequence;
+        PageMutation mutation;
+    };
+    // published last by setPageMutationQueue, so a posting thread seeing it sees the cells and the mask
+    std::atomic<PageMutationCell*> _pageMutationCells;
+    size_t _pageMutationMask;
+    std::atomic<size_t> _pageMutationEnqueuePos;
+    // only touched by the main thread
+    size_t _pageMutationDequeuePos;
+    int _pageMutationsPerFrame;
+    ccCreateItemPageCallback _createItemPageCallback;
+
+    // builders of the deferred pages not built yet
+    std::unordered_map<Layout*, ccBuildPageCallback> _pageBuilders;
+    ccBuildPageCallback _pagePlaceholderCallback;
+    float _pageBuildBudget;
 };
 
 }
@@ -0,0 +1,383 @@
+#include "lua_cocos2dx_ui_pagecenteredview_manual.hpp"
+#include "ui/UIPageCenteredView.h"
+#include "tolua_fix.h"
+#include "LuaBasicConversions.h"
+#include "CCLuaValue.h"
+#include "CCLuaEngine.h"
+#include "LuaScriptHandlerMgr.h"
+
+using namespace cocos2d;
+using namespace cocos2d::ui;
+
+// checks self and the number of arguments, raises a lua error on mismatch
+static PageCenteredView* toPageCenteredView(lua_State* L, const char* funcName, int minArgc, int maxArgc)
+{
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertype(L, 1, "ccui.PageCenteredView", 0, &tolua_err))
+    {
+        tolua_error(L, StringUtils::format("#ferror in function '%s'.", funcName).c_str(), &tolua_err);
+        return nullptr;
+    }
+#endif
+    auto self = static_cast<PageCenteredView*>(tolua_tousertype(L, 1, 0));
+    if (nullptr == self)
+    {
+        tolua_error(L, StringUtils::format("invalid 'self' in function '%s'\n", funcName).c_str(), nullptr);
+        return nullptr;
+    }
+    int argc = lua_gettop(L) - 1;
+    if (argc < minArgc || argc > maxArgc)
+    {
+        luaL_error(L, "'%s' function of PageCenteredView has wrong number of arguments: %d, was expecting %d\n", funcName, argc, minArgc);
+        return nullptr;
+    }
+    return self;
+}
+
+static Layout* toLayout(lua_State* L, int lo)
+{
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertype(L, lo, "ccui.Layout", 0, &tolua_err))
+    {
+        tolua_error(L, "#ferror in function 'PageCenteredView', a ccui.Layout is expected.", &tolua_err);
+        return nullptr;
+    }
+#endif
+    return static_cast<Layout*>(tolua_tousertype(L, lo, 0));
+}
+
+static int toHandler(lua_State* L, int lo, PageCenteredView* self)
+{
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!toluafix_isfunction(L, lo, "LUA_FUNCTION", 0, &tolua_err))
+    {
+        tolua_error(L, "#ferror in function 'PageCenteredView', a function is expected.", &tolua_err);
+        return 0;
+    }
+#endif
+    LUA_FUNCTION handler = toluafix_ref_function(L, lo, 0);
+    // released with the view
+    ScriptHandlerMgr::getInstance()->addCustomHandler((void*)self, handler);
+    return handler;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_create(lua_State* L)
+{
+    int argc = lua_gettop(L) - 1;
+    if (0 == argc)
+    {
+        object_to_luaval<PageCenteredView>(L, "ccui.PageCenteredView", PageCenteredView::create());
+        return 1;
+    }
+    luaL_error(L, "'create' function of PageCenteredView has wrong number of arguments: %d, was expecting %d\n", argc, 0);
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_addPage(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "addPage", 1, 1);
+    Layout* page = self ? toLayout(L, 2) : nullptr;
+    if (nullptr == page)
+        return 0;
+    self->addPage(page);
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_insertPage(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "insertPage", 2, 2);
+    Layout* page = self ? toLayout(L, 2) : nullptr;
+    if (nullptr == page)
+        return 0;
+    self->insertPage(page, (int)tolua_tonumber(L, 3, 0));
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_removePage(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "removePage", 1, 1);
+    Layout* page = self ? toLayout(L, 2) : nullptr;
+    if (nullptr == page)
+        return 0;
+    self->removePage(page);
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_removePageAtIndex(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "removePageAtIndex", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->removePageAtIndex((ssize_t)tolua_tonumber(L, 2, 0));
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_removeAllPages(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "removeAllPages", 0, 0);
+    if (nullptr == self)
+        return 0;
+    self->removeAllPages();
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_getPage(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "getPage", 1, 1);
+    if (nullptr == self)
+        return 0;
+    object_to_luaval<Layout>(L, "ccui.Layout", self->getPage((ssize_t)tolua_tonumber(L, 2, 0)));
+    return 1;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_getPages(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "getPages", 0, 0);
+    if (nullptr == self)
+        return 0;
+    ccvector_to_luaval(L, self->getPages());
+    return 1;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_scrollToPage(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "scrollToPage", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->scrollToPage((ssize_t)tolua_tonumber(L, 2, 0));
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setCurPageIndex(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setCurPageIndex", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->setCurPageIndex((ssize_t)tolua_tonumber(L, 2, 0));
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_getCurPageIndex(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "getCurPageIndex", 0, 0);
+    if (nullptr == self)
+        return 0;
+    tolua_pushnumber(L, (lua_Number)self->getCurPageIndex());
+    return 1;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setShowedNum(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setShowedNum", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->setShowedNum((int)tolua_tonumber(L, 2, 0));
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_getShowedNum(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "getShowedNum", 0, 0);
+    if (nullptr == self)
+        return 0;
+    tolua_pushnumber(L, (lua_Number)self->getShowedNum());
+    return 1;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setDirection(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setDirection", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->setDirection((PageCenteredView::Direction)(int)tolua_tonumber(L, 2, 0));
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_getDirection(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "getDirection", 0, 0);
+    if (nullptr == self)
+        return 0;
+    tolua_pushnumber(L, (lua_Number)(int)self->getDirection());
+    return 1;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setCustomScrollThreshold(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setCustomScrollThreshold", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->setCustomScrollThreshold((float)tolua_tonumber(L, 2, 0));
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_getCustomScrollThreshold(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "getCustomScrollThreshold", 0, 0);
+    if (nullptr == self)
+        return 0;
+    tolua_pushnumber(L, (lua_Number)self->getCustomScrollThreshold());
+    return 1;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setUsingCustomScrollThreshold(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setUsingCustomScrollThreshold", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->setUsingCustomScrollThreshold(tolua_toboolean(L, 2, 0) != 0);
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_isUsingCustomScrollThreshold(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "isUsingCustomScrollThreshold", 0, 0);
+    if (nullptr == self)
+        return 0;
+    tolua_pushboolean(L, self->isUsingCustomScrollThreshold());
+    return 1;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setCircularEnabled(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setCircularEnabled", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->setCircularEnabled(tolua_toboolean(L, 2, 0) != 0);
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setFlingEnabled(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setFlingEnabled", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->setFlingEnabled(tolua_toboolean(L, 2, 0) != 0);
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setPageEffectEnabled(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setPageEffectEnabled", 1, 1);
+    if (nullptr == self)
+        return 0;
+    self->setPageEffectEnabled(tolua_toboolean(L, 2, 0) != 0);
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setPageEffect(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setPageEffect", 3, 4);
+    if (nullptr == self)
+        return 0;
+    self->setPageEffect((float)tolua_tonumber(L, 2, 0), (float)tolua_tonumber(L, 3, 0), (float)tolua_tonumber(L, 4, 0), (float)tolua_tonumber(L, 5, 1));
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_addEventListener(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "addEventListener", 1, 1);
+    int handler = self ? toHandler(L, 2, self) : 0;
+    if (0 == handler)
+        return 0;
+    self->addEventListener([=](Ref* sender, PageCenteredView::EventType eventType){
+        LuaStack* stack = LuaEngine::getInstance()->getLuaStack();
+        stack->pushObject(sender, "cc.Ref");
+        stack->pushInt((int)eventType);
+        stack->executeFunctionByHandler(handler, 2);
+        stack->clean();
+    });
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_setDataSource(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "setDataSource", 2, 3);
+    int countHandler = self ? toHandler(L, 2, self) : 0;
+    int configureHandler = countHandler ? toHandler(L, 3, self) : 0;
+    if (0 == configureHandler)
+        return 0;
+    int margin = (int)tolua_tonumber(L, 4, 1);
+    self->setDataSource([=]() -> ssize_t {
+        ssize_t count = 0;
+        LuaStack* stack = LuaEngine::getInstance()->getLuaStack();
+        stack->executeFunction(countHandler, 0, 1, [&count](lua_State* L, int numReturn){
+            count = (ssize_t)lua_tonumber(L, -1);
+            lua_pop(L, 1);
+        });
+        stack->clean();
+        return count;
+    }, [=](Layout* page, ssize_t idx){
+        LuaStack* stack = LuaEngine::getInstance()->getLuaStack();
+        stack->pushObject(page, "ccui.Layout");
+        stack->pushLong((long)idx);
+        stack->executeFunctionByHandler(configureHandler, 2);
+        stack->clean();
+    }, margin);
+    return 0;
+}
+
+static int lua_cocos2dx_ui_PageCenteredView_reloadData(lua_State* L)
+{
+    auto self = toPageCenteredView(L, "reloadData", 0, 0);
+    if (nullptr == self)
+        return 0;
+    self->reloadData();
+    return 0;
+}
+
+static int lua_register_cocos2dx_ui_PageCenteredView(lua_State* L)
+{
+    tolua_usertype(L, "ccui.PageCenteredView");
+    tolua_cclass(L, "PageCenteredView", "ccui.PageCenteredView", "ccui.Layout", nullptr);
+
+    tolua_beginmodule(L, "PageCenteredView");
+        tolua_function(L, "create", lua_cocos2dx_ui_PageCenteredView_create);
+        tolua_function(L, "addPage", lua_cocos2dx_ui_PageCenteredView_addPage);
+        tolua_function(L, "insertPage", lua_cocos2dx_ui_PageCenteredView_insertPage);
+        tolua_function(L, "removePage", lua_cocos2dx_ui_PageCenteredView_removePage);
+        tolua_function(L, "removePageAtIndex", lua_cocos2dx_ui_PageCenteredView_removePageAtIndex);
+        tolua_function(L, "removeAllPages", lua_cocos2dx_ui_PageCenteredView_removeAllPages);
+        tolua_function(L, "getPage", lua_cocos2dx_ui_PageCenteredView_getPage);
+        tolua_function(L, "getPages", lua_cocos2dx_ui_PageCenteredView_getPages);
+        tolua_function(L, "scrollToPage", lua_cocos2dx_ui_PageCenteredView_scrollToPage);
+        tolua_function(L, "setCurPageIndex", lua_cocos2dx_ui_PageCenteredView_setCurPageIndex);
+        tolua_function(L, "getCurPageIndex", lua_cocos2dx_ui_PageCenteredView_getCurPageIndex);
+        tolua_function(L, "setShowedNum", lua_cocos2dx_ui_PageCenteredView_setShowedNum);
+        tolua_function(L, "getShowedNum", lua_cocos2dx_ui_PageCenteredView_getShowedNum);
+        tolua_function(L, "setDirection", lua_cocos2dx_ui_PageCenteredView_setDirection);
+        tolua_function(L, "getDirection", lua_cocos2dx_ui_PageCenteredView_getDirection);
+        tolua_function(L, "setCustomScrollThreshold", lua_cocos2dx_ui_PageCenteredView_setCustomScrollThreshold);
+        tolua_function(L, "getCustomScrollThreshold", lua_cocos2dx_ui_PageCenteredView_getCustomScrollThreshold);
+        tolua_function(L, "setUsingCustomScrollThreshold", lua_cocos2dx_ui_PageCenteredView_setUsingCustomScrollThreshold);
+        tolua_function(L, "isUsingCustomScrollThreshold", lua_cocos2dx_ui_PageCenteredView_isUsingCustomScrollThreshold);
+        tolua_function(L, "setCircularEnabled", lua_cocos2dx_ui_PageCenteredView_setCircularEnabled);
+        tolua_function(L, "setFlingEnabled", lua_cocos2dx_ui_PageCenteredView_setFlingEnabled);
+        tolua_function(L, "setPageEffectEnabled", lua_cocos2dx_ui_PageCenteredView_setPageEffectEnabled);
+        tolua_function(L, "setPageEffect", lua_cocos2dx_ui_PageCenteredView_setPageEffect);
+        tolua_function(L, "addEventListener", lua_cocos2dx_ui_PageCenteredView_addEventListener);
+        tolua_function(L, "setDataSource", lua_cocos2dx_ui_PageCenteredView_setDataSource);
+        tolua_function(L, "reloadData", lua_cocos2dx_ui_PageCenteredView_reloadData);
+    tolua_endmodule(L);
+
+    std::string typeName = typeid(PageCenteredView).name();
+    g_luaType[typeName] = "ccui.PageCenteredView";
+    g_typeCast["PageCenteredView"] = "ccui.PageCenteredView";
+    return 1;
+}
+
+int register_pagecenteredview_manual(lua_State* L)
+{
+    if (nullptr == L)
+        return 0;
+
+    tolua_open(L);
+    tolua_module(L, "ccui", 0);
+    tolua_beginmodule(L, "ccui");
+        lua_register_cocos2dx_ui_PageCenteredView(L);
+    tolua_endmodule(L);
+    return 1;
+}
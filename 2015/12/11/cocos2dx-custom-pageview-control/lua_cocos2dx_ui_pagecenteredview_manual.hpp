@@ -0,0 +1,17 @@
+#ifndef __LUA_COCOS2DX_UI_PAGECENTEREDVIEW_MANUAL_H__
+#define __LUA_COCOS2DX_UI_PAGECENTEREDVIEW_MANUAL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "tolua++.h"
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * Register ccui.PageCenteredView, call it after register_all_cocos2dx_ui.
+ */
+TOLUA_API int register_pagecenteredview_manual(lua_State* L);
+
+#endif // #ifndef __LUA_COCOS2DX_UI_PAGECENTEREDVIEW_MANUAL_H__